@@ -3,6 +3,7 @@
 #include "building/distribution.h"
 #include "building/industry.h"
 #include "building/granary.h"
+#include "building/house_population.h"
 #include "building/menu.h"
 #include "building/model.h"
 #include "building/monument.h"
@@ -11,6 +12,7 @@
 #include "building/state.h"
 #include "building/storage.h"
 #include "building/variant.h"
+#include "building/warehouse.h"
 #include "city/buildings.h"
 #include "city/finance.h"
 #include "city/population.h"
@@ -113,6 +115,9 @@ building *building_next(building *b)
 
 static void fill_adjacent_types(building *b)
 {
+    if (building_is_house(b->type)) {
+        house_population_mark_index_changed();
+    }
     building *first = data.first_of_type[b->type];
     building *last = data.last_of_type[b->type];
     if (!first || !last) {
@@ -149,6 +154,9 @@ static void fill_adjacent_types(building *b)
 
 static void remove_adjacent_types(building *b)
 {
+    if (building_is_house(b->type)) {
+        house_population_mark_index_changed();
+    }
     building *first = data.first_of_type[b->type];
     building *last = data.last_of_type[b->type];
     if (b == first && b == last) {
@@ -292,6 +300,7 @@ building *building_restore_from_undo(building *to_restore)
         data.buildings.size = b->id + 1;
     }
     fill_adjacent_types(b);
+    building_warehouse_clear_stock_cache();
     return b;
 }
 
@@ -598,6 +607,8 @@ void building_clear_all(void)
 {
     memset(data.first_of_type, 0, sizeof(data.first_of_type));
     memset(data.last_of_type, 0, sizeof(data.last_of_type));
+    building_warehouse_clear_stock_cache();
+    house_population_mark_index_changed();
 
     if (!array_init(data.buildings, BUILDING_ARRAY_SIZE_STEP, initialize_new_building, building_in_use) ||
         !array_next(data.buildings)) { // Ignore first building
@@ -656,6 +667,7 @@ void building_load_state(buffer *buf, buffer *sequence, buffer *corrupt_houses,
 
     memset(data.first_of_type, 0, sizeof(data.first_of_type));
     memset(data.last_of_type, 0, sizeof(data.last_of_type));
+    building_warehouse_clear_stock_cache();
 
     int highest_id_in_use = 0;
 
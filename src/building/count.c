@@ -6,8 +6,6 @@
 #include "city/buildings.h"
 #include "city/health.h"
 #include "figure/figure.h"
-#include "map/building.h"
-#include "map/grid.h"
 
 static const building_type building_set_farms[] = {
     BUILDING_WHEAT_FARM, BUILDING_VEGETABLE_FARM, BUILDING_FRUIT_FARM, BUILDING_OLIVE_FARM,
@@ -147,90 +145,61 @@ int building_count_upgraded(building_type type)
     return upgraded;
 }
 
-int building_count_in_area(building_type type, int minx, int miny, int maxx, int maxy)
+static int building_is_in_area(building *b, int minx, int miny, int maxx, int maxy)
 {
-    int grid_area = (abs(maxx - minx) + 1) * (abs(maxy - miny) + 1);
-    int array_size = grid_area < building_count() ? grid_area : building_count();
-    unsigned int *found_buildings = (unsigned int *) malloc(array_size * sizeof(unsigned int));
-    memset(found_buildings, 0, array_size * sizeof(unsigned int));
-
-    int total = 0;
-    for (int x = minx; x <= maxx; x++) {
-        for (int y = miny; y <= maxy; y++) {
-            int grid_offset = map_grid_offset(x, y);
-            int building_id = map_building_at(grid_offset);
-            if (building_id) {
-                building *b = building_main(building_get(building_id));
-                if (type != BUILDING_ANY && b->type != type) {
-                    continue;
-                }
-                if (b->state != BUILDING_STATE_IN_USE && b->state != BUILDING_STATE_CREATED) {
-                    continue;
-                }
-
-                int building_already_counted = 0;
-
-                for (int i = 0; i < total; i++) {
-                    if (found_buildings[i] == b->id) {
-                        building_already_counted = 1;
-                        break;
-                    }
-                }
+    // Buildings with several parts, like the hippodrome or a fort and its grounds, count if any part is in the area
+    for (int guard = 0; guard < 9; guard++) {
+        int last_tile = b->size > 1 ? b->size - 1 : 0;
+        if (b->x <= maxx && b->x + last_tile >= minx && b->y <= maxy && b->y + last_tile >= miny) {
+            return 1;
+        }
+        if (b->next_part_building_id <= 0) {
+            return 0;
+        }
+        b = building_next(b);
+    }
+    return 0;
+}
 
-                if (building_already_counted) {
-                    continue;
-                }
+static int is_counted_in_area(building *b, int minx, int miny, int maxx, int maxy)
+{
+    return (b->state == BUILDING_STATE_IN_USE || b->state == BUILDING_STATE_CREATED) && b == building_main(b) &&
+        building_is_in_area(b, minx, miny, maxx, maxy);
+}
 
-                found_buildings[total] = b->id;
+int building_count_in_area(building_type type, int minx, int miny, int maxx, int maxy)
+{
+    if (minx > maxx || miny > maxy) {
+        return 0;
+    }
+    int total = 0;
+    if (type == BUILDING_ANY) {
+        for (int id = 1; id < building_count(); id++) {
+            if (is_counted_in_area(building_get(id), minx, miny, maxx, maxy)) {
                 total++;
             }
         }
+        return total;
+    }
+    for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+        if (is_counted_in_area(b, minx, miny, maxx, maxy)) {
+            total++;
+        }
     }
-
-    free(found_buildings);
     return total;
 }
 
 int building_count_fort_type_in_area(int minx, int miny, int maxx, int maxy, figure_type type)
 {
-    int grid_area = abs((maxx - minx) * (maxy - miny));
-    int array_size = grid_area < building_count() ? grid_area : building_count();
-    int *found_buildings = (int *) malloc(array_size * sizeof(int));
-
+    if (minx > maxx || miny > maxy) {
+        return 0;
+    }
     int total = 0;
-    for (int x = minx; x <= maxx; x++) {
-        for (int y = miny; y <= maxy; y++) {
-            int grid_offset = map_grid_offset(x, y);
-            int building_id = map_building_at(grid_offset);
-            if (building_id) {
-                building *b = building_main(building_get(building_id));
-                if (b->type != BUILDING_FORT || b->subtype.fort_figure_type != type) {
-                    continue;
-                }
-                if (b->state != BUILDING_STATE_IN_USE && b->state != BUILDING_STATE_CREATED) {
-                    continue;
-                }
-
-                int building_already_counted = 0;
-
-                for (int i = 0; i < total; i++) {
-                    if (found_buildings[i] == b->id) {
-                        building_already_counted = 1;
-                        break;
-                    }
-                }
-
-                if (building_already_counted) {
-                    continue;
-                }
-
-                found_buildings[total] = b->id;
-                total++;
-            }
+    for (building *b = building_first_of_type(BUILDING_FORT); b; b = b->next_of_type) {
+        if (b->subtype.fort_figure_type == type && is_counted_in_area(b, minx, miny, maxx, maxy)) {
+            total++;
         }
     }
-
-    free(found_buildings);
     return total;
 }
 
@@ -8,16 +8,140 @@
 #include "city/migration.h"
 #include "city/population.h"
 #include "core/calc.h"
+#include "core/log.h"
 #include "figuretype/migrant.h"
 
+#include <stdlib.h>
+
+#define PLENTY_OF_ROOM 8
+
+// Houses that can take in people, so births and immigration don't have to walk every building.
+// Rebuilt with the room of the houses each day, and again before use if the house lists changed since.
+// Entries are rechecked when used, so houses that lost their room or access are simply skipped.
+static struct {
+    int *reachable; // houses with access to Rome, by building id
+    int num_reachable;
+    int *with_room; // reachable houses with room, in house type order
+    int num_with_room;
+    int *plenty_of_room; // the houses with room for a full immigrant cart, in house type order
+    int num_plenty_of_room;
+    int size;
+    int changed;
+} vacancy_index = { .changed = 1 };
+
+void house_population_mark_index_changed(void)
+{
+    vacancy_index.changed = 1;
+}
+
+void house_population_set_room(building *house, int room)
+{
+    // More room than when the index was built means the house may be missing from it
+    if (room > house->house_population_room) {
+        vacancy_index.changed = 1;
+    }
+    house->house_population_room = room;
+}
+
+static int start_index(void)
+{
+    int size = building_count();
+    if (size > vacancy_index.size) {
+        int *reachable = realloc(vacancy_index.reachable, sizeof(int) * size);
+        if (reachable) {
+            vacancy_index.reachable = reachable;
+        }
+        int *with_room = realloc(vacancy_index.with_room, sizeof(int) * size);
+        if (with_room) {
+            vacancy_index.with_room = with_room;
+        }
+        int *plenty_of_room = realloc(vacancy_index.plenty_of_room, sizeof(int) * size);
+        if (plenty_of_room) {
+            vacancy_index.plenty_of_room = plenty_of_room;
+        }
+        if (!reachable || !with_room || !plenty_of_room) {
+            log_error("Unable to allocate memory for the housing vacancy index", 0, 0);
+            vacancy_index.changed = 1;
+            vacancy_index.num_reachable = 0;
+            vacancy_index.num_with_room = 0;
+            vacancy_index.num_plenty_of_room = 0;
+            return 0;
+        }
+        vacancy_index.size = size;
+    }
+    vacancy_index.num_reachable = 0;
+    vacancy_index.num_with_room = 0;
+    vacancy_index.num_plenty_of_room = 0;
+    return 1;
+}
+
+static void add_to_index(const building *house)
+{
+    if (house->distance_from_entry <= 0) {
+        return;
+    }
+    vacancy_index.reachable[vacancy_index.num_reachable++] = house->id;
+    if (house->house_population_room > 0) {
+        vacancy_index.with_room[vacancy_index.num_with_room++] = house->id;
+    }
+    if (house->house_population_room >= PLENTY_OF_ROOM) {
+        vacancy_index.plenty_of_room[vacancy_index.num_plenty_of_room++] = house->id;
+    }
+}
+
+static int compare_ids(const void *a, const void *b)
+{
+    return *(const int *) a - *(const int *) b;
+}
+
+static void finish_index(void)
+{
+    qsort(vacancy_index.reachable, vacancy_index.num_reachable, sizeof(int), compare_ids);
+    vacancy_index.changed = 0;
+}
+
+static void update_index(void)
+{
+    if (!vacancy_index.changed) {
+        return;
+    }
+    if (!start_index()) {
+        return;
+    }
+    for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
+        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+            if (b->state == BUILDING_STATE_IN_USE && b->house_size) {
+                add_to_index(b);
+            }
+        }
+    }
+    finish_index();
+}
+
+static int first_reachable_after(int building_id)
+{
+    int low = 0;
+    int high = vacancy_index.num_reachable;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (vacancy_index.reachable[mid] <= building_id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < vacancy_index.num_reachable ? low : 0;
+}
+
 int house_population_add_to_city(int num_people)
 {
+    update_index();
     int added = 0;
-    int building_id = city_population_last_used_house_add();
-    for (int i = 1; i < building_count() && added < num_people; i++) {
-        if (++building_id >= building_count()) {
-            building_id = 1;
-        }
+    // Visit the reachable houses once, in building id order starting after the last used one,
+    // which are the only buildings the walk over all building ids would stop at
+    int start = first_reachable_after(city_population_last_used_house_add());
+    for (int i = 0; i < vacancy_index.num_reachable && added < num_people; i++) {
+        int building_id = vacancy_index.reachable[(start + i) % vacancy_index.num_reachable];
         building *b = building_get(building_id);
         if (b->state == BUILDING_STATE_IN_USE && b->house_size
             && b->distance_from_entry > 0 && b->house_population > 0) {
@@ -26,7 +150,7 @@ int house_population_add_to_city(int num_people)
             if (b->house_population < max_people) {
                 ++added;
                 ++b->house_population;
-                b->house_population_room = max_people - b->house_population;
+                house_population_set_room(b, max_people - b->house_population);
             }
         }
     }
@@ -72,6 +196,7 @@ int house_population_get_capacity(building *house)
 void house_population_update_room(void)
 {
     city_population_clear_capacity();
+    int has_index = start_index();
 
     for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
         for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
@@ -90,8 +215,20 @@ void house_population_update_room(void)
                 // not connected to Rome, mark people for eviction
                 b->house_population_room = -b->house_population;
             }
+            if (has_index) {
+                add_to_index(b);
+            }
         }
     }
+    if (has_index) {
+        finish_index();
+    }
+}
+
+static int can_take_immigrants(const building *b)
+{
+    return b->state == BUILDING_STATE_IN_USE && b->house_size && !b->has_plague &&
+        b->distance_from_entry > 0 && !b->immigrant_figure_id;
 }
 
 int house_population_create_immigrants(int num_people)
@@ -105,43 +242,37 @@ int house_population_create_immigrants(int num_people)
             }
         }
     }
+    update_index();
     // houses with plenty of room
-    for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE && to_immigrate > 0; type++) {
-        for (building *b = building_first_of_type(type); b && to_immigrate > 0; b = b->next_of_type) {
-            if (b->state != BUILDING_STATE_IN_USE || !b->house_size || b->has_plague) {
-                continue;
-            }
-            if (b->distance_from_entry > 0 && b->house_population_room >= 8 && !b->immigrant_figure_id) {
-                if (to_immigrate <= 4) {
-                    figure_create_immigrant(b, to_immigrate);
-                    to_immigrate = 0;
-                } else {
-                    figure_create_immigrant(b, 4);
-                    to_immigrate -= 4;
-                }
+    for (int i = 0; i < vacancy_index.num_plenty_of_room && to_immigrate > 0; i++) {
+        building *b = building_get(vacancy_index.plenty_of_room[i]);
+        if (can_take_immigrants(b) && b->house_population_room >= PLENTY_OF_ROOM) {
+            if (to_immigrate <= 4) {
+                figure_create_immigrant(b, to_immigrate);
+                to_immigrate = 0;
+            } else {
+                figure_create_immigrant(b, 4);
+                to_immigrate -= 4;
             }
         }
     }
     // houses with less room
-    for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE && to_immigrate > 0; type++) {
-        for (building *b = building_first_of_type(type); b && to_immigrate > 0; b = b->next_of_type) {
-            if (b->state != BUILDING_STATE_IN_USE || !b->house_size || b->has_plague) {
-                continue;
-            }
-            if (b->distance_from_entry > 0 && b->house_population_room > 0 && !b->immigrant_figure_id) {
-                if (to_immigrate <= b->house_population_room) {
-                    figure_create_immigrant(b, to_immigrate);
-                    to_immigrate = 0;
-                } else {
-                    figure_create_immigrant(b, b->house_population_room);
-                    to_immigrate -= b->house_population_room;
-                }
+    for (int i = 0; i < vacancy_index.num_with_room && to_immigrate > 0; i++) {
+        building *b = building_get(vacancy_index.with_room[i]);
+        if (can_take_immigrants(b) && b->house_population_room > 0) {
+            if (to_immigrate <= b->house_population_room) {
+                figure_create_immigrant(b, to_immigrate);
+                to_immigrate = 0;
+            } else {
+                figure_create_immigrant(b, b->house_population_room);
+                to_immigrate -= b->house_population_room;
             }
         }
     }
     return num_people - to_immigrate;
 }
 
+// Emigrants leave occupied houses, which the vacancy index does not track, so this still walks the house lists
 int house_population_create_emigrants(int num_people)
 {
     int to_emigrate = num_people;
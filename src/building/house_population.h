@@ -48,4 +48,16 @@ int house_population_create_emigrants(int num_people);
 
 int house_population_get_capacity(building *house);
 
+/**
+ * Sets the room available in a house, keeping the vacancy index up to date
+ * @param house House to update
+ * @param room Number of people the house can still take in, negative when overcrowded
+ */
+void house_population_set_room(building *house, int room);
+
+/**
+ * Marks the vacancy index as outdated, to be called when houses are added, removed or change type
+ */
+void house_population_mark_index_changed(void);
+
 #endif // BUILDING_HOUSE_POPULATION_H
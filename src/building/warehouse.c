@@ -17,12 +17,105 @@
 #include "map/image.h"
 #include "scenario/property.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #define INFINITE 10000
 
 #define MAX_CARTLOADS_PER_SPACE 4
 
+// Stock totals of a warehouse, so queries don't have to walk its 8 spaces.
+// Kept per building id and recalculated after any of its spaces changes.
+typedef struct {
+    int created_sequence;
+    uint8_t is_valid;
+    uint8_t is_complete; // all 8 spaces exist, otherwise the callers walk the spaces themselves
+    uint8_t empty_spaces;
+    uint8_t spaces[RESOURCE_MAX];
+    uint8_t spaces_with_room[RESOURCE_MAX];
+    int16_t total_loads;
+    int16_t loads[RESOURCE_MAX];
+} warehouse_stock;
+
+static struct {
+    warehouse_stock *items;
+    int size;
+} stock_cache;
+
+void building_warehouse_clear_stock_cache(void)
+{
+    free(stock_cache.items);
+    stock_cache.items = 0;
+    stock_cache.size = 0;
+}
+
+static void invalidate_stock(const building *warehouse)
+{
+    if (warehouse->id > 0 && warehouse->id < stock_cache.size) {
+        stock_cache.items[warehouse->id].is_valid = 0;
+    }
+}
+
+static void calculate_stock(building *warehouse, warehouse_stock *stock)
+{
+    memset(stock, 0, sizeof(warehouse_stock));
+    stock->created_sequence = warehouse->created_sequence;
+    stock->is_valid = 1;
+    building *space = warehouse;
+    for (int i = 0; i < 8; i++) {
+        space = building_next(space);
+        if (space->id <= 0) {
+            return;
+        }
+        int resource = space->subtype.warehouse_resource_id;
+        if (resource) {
+            stock->spaces[resource]++;
+            stock->loads[resource] += space->resources[resource];
+            stock->total_loads += space->resources[resource];
+            if (space->resources[resource] < MAX_CARTLOADS_PER_SPACE) {
+                stock->spaces_with_room[resource]++;
+            }
+        } else {
+            stock->empty_spaces++;
+        }
+    }
+    stock->is_complete = 1;
+}
+
+static const warehouse_stock *get_stock(building *warehouse)
+{
+    if (warehouse->id <= 0) {
+        return 0;
+    }
+    if (warehouse->id >= stock_cache.size) {
+        int new_size = building_count() > warehouse->id ? building_count() : warehouse->id + 1;
+        warehouse_stock *items = realloc(stock_cache.items, sizeof(warehouse_stock) * new_size);
+        if (!items) {
+            return 0;
+        }
+        memset(items + stock_cache.size, 0, sizeof(warehouse_stock) * (new_size - stock_cache.size));
+        stock_cache.items = items;
+        stock_cache.size = new_size;
+    }
+    warehouse_stock *stock = &stock_cache.items[warehouse->id];
+    if (!stock->is_valid || stock->created_sequence != warehouse->created_sequence) {
+        calculate_stock(warehouse, stock);
+    }
+    return stock->is_complete ? stock : 0;
+}
+
 int building_warehouse_get_space_info(building *warehouse)
 {
+    const warehouse_stock *stock = get_stock(warehouse);
+    if (stock) {
+        if (stock->empty_spaces > 0) {
+            return WAREHOUSE_ROOM;
+        } else if (stock->total_loads < FULL_WAREHOUSE) {
+            return WAREHOUSE_SOME_ROOM;
+        } else {
+            return WAREHOUSE_FULL;
+        }
+    }
     int total_loads = 0;
     int empty_spaces = 0;
     building *space = warehouse;
@@ -48,6 +141,10 @@ int building_warehouse_get_space_info(building *warehouse)
 
 int building_warehouse_get_amount(building *warehouse, int resource)
 {
+    const warehouse_stock *stock = get_stock(warehouse);
+    if (stock && resource != RESOURCE_NONE) {
+        return stock->loads[resource];
+    }
     int loads = 0;
     building *space = warehouse;
     for (int i = 0; i < 8; i++) {
@@ -216,6 +313,7 @@ void building_warehouse_remove_resource_curse(building *warehouse, int amount)
 
 void building_warehouse_space_set_image(building *space, int resource)
 {
+    invalidate_stock(building_main(space));
     int image_id;
     if (building_loads_stored(space) <= 0) {
         image_id = image_group(GROUP_BUILDING_WAREHOUSE_STORAGE_EMPTY);
@@ -359,6 +457,10 @@ int building_warehouse_maximum_receptible_amount(resource_type resource, buildin
 
 int building_warehouse_max_space_for_resource(resource_type resource, building *b)
 {
+    const warehouse_stock *stock = get_stock(b);
+    if (stock && resource != RESOURCE_NONE) {
+        return MAX_CARTLOADS_PER_SPACE * (stock->spaces[resource] + stock->empty_spaces) - stock->loads[resource];
+    }
     int max_storable = 0;
     building *space = b;
     for (int i = 0; i < 8; i++) {
@@ -487,6 +589,10 @@ int building_warehouse_accepts_storage(building *b, int resource, int *understaf
         }
         return 0;
     }
+    const warehouse_stock *stock = get_stock(b);
+    if (stock && resource != RESOURCE_NONE) {
+        return stock->empty_spaces > 0 || stock->spaces_with_room[resource] > 0;
+    }
     building *space = b;
     for (int t = 0; t < 8; t++) {
         space = building_next(space);
@@ -525,6 +631,10 @@ int building_warehouse_for_storing(int src_building_id, int x, int y, int resour
 
 int building_warehouse_amount_can_get_from(building *destination, int resource)
 {
+    const warehouse_stock *stock = get_stock(destination);
+    if (stock && resource != RESOURCE_NONE) {
+        return stock->loads[resource];
+    }
     int loads_stored = 0;
     building *space = destination;
     for (int t = 0; t < 8; t++) {
@@ -589,14 +699,7 @@ int building_warehouse_with_resource(int x, int y, int resource, int road_networ
             }
             continue;
         }
-        int loads_stored = 0;
-        building *space = b;
-        for (int t = 0; t < 8; t++) {
-            space = building_next(space);
-            if (space->id > 0 && space->subtype.warehouse_resource_id == resource) {
-                loads_stored += space->resources[resource];
-            }
-        }
+        int loads_stored = building_warehouse_amount_can_get_from(b, resource);
         if (loads_stored > 0) {
             int dist = calc_maximum_distance(b->x, b->y, x, y);
             dist -= 2 * loads_stored;
@@ -702,24 +805,22 @@ int building_warehouse_determine_worker_task(building *warehouse, int *resource)
         if (!building_warehouse_is_getting(r, warehouse) || city_resource_is_stockpiled(r) || !resource_is_storable(r)) {
             continue;
         }
-        int loads_stored = 0;
-        space = warehouse;
-        for (int i = 0; i < 8; i++) {
-            space = building_next(space);
-            if (space->id > 0 && space->subtype.warehouse_resource_id == r) {
-                loads_stored += space->resources[r];
-            }
-        }
+        int loads_stored = building_warehouse_amount_can_get_from(warehouse, r);
         int room = 0;
-        space = warehouse;
-        for (int i = 0; i < 8; i++) {
-            space = building_next(space);
-            if (space->id > 0) {
-                resource_type space_resource = space->subtype.warehouse_resource_id;
-                if (space_resource == RESOURCE_NONE) {
-                    room += MAX_CARTLOADS_PER_SPACE;
-                } else if (r == space_resource) {
-                    room += MAX_CARTLOADS_PER_SPACE - space->resources[space_resource];
+        const warehouse_stock *stock = get_stock(warehouse);
+        if (stock) {
+            room = MAX_CARTLOADS_PER_SPACE * (stock->spaces[r] + stock->empty_spaces) - stock->loads[r];
+        } else {
+            space = warehouse;
+            for (int i = 0; i < 8; i++) {
+                space = building_next(space);
+                if (space->id > 0) {
+                    resource_type space_resource = space->subtype.warehouse_resource_id;
+                    if (space_resource == RESOURCE_NONE) {
+                        room += MAX_CARTLOADS_PER_SPACE;
+                    } else if (r == space_resource) {
+                        room += MAX_CARTLOADS_PER_SPACE - space->resources[space_resource];
+                    }
                 }
             }
         }
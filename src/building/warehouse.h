@@ -22,6 +22,8 @@ enum {
     WAREHOUSE_TASK_DELIVERING = 1
 };
 
+void building_warehouse_clear_stock_cache(void);
+
 int building_warehouse_get_space_info(building *warehouse);
 
 int building_warehouse_get_amount(building *warehouse, int resource);
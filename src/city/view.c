@@ -9,6 +9,7 @@
 #include "graphics/renderer.h"
 #include "map/grid.h"
 #include "map/image.h"
+#include "widget/city_without_overlay.h"
 #include "widget/minimap.h"
 
 #define TILE_WIDTH_PIXELS 60
@@ -220,6 +221,7 @@ void city_view_init(void)
     calculate_lookup();
     city_view_set_scale(100);
     widget_minimap_invalidate();
+    city_without_overlay_invalidate_terrain_cache();
 }
 
 int city_view_orientation(void)
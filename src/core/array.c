@@ -28,3 +28,54 @@ void array_free(void **data, unsigned int blocks)
     }
     free(data);
 }
+
+int array_grow_free_slots(uint32_t **free_slots, unsigned int *words, unsigned int capacity)
+{
+    unsigned int needed_words = capacity / 32 + 1;
+    if (*free_slots && needed_words <= *words) {
+        return 1;
+    }
+    uint32_t *new_free_slots = realloc(*free_slots, sizeof(uint32_t) * needed_words);
+    if (!new_free_slots) {
+        return 0;
+    }
+    unsigned int old_words = *free_slots ? *words : 0;
+    memset(new_free_slots + old_words, 0, sizeof(uint32_t) * (needed_words - old_words));
+    *free_slots = new_free_slots;
+    *words = needed_words;
+    return 1;
+}
+
+void array_mark_free_slots(uint32_t *free_slots, unsigned int start, unsigned int end)
+{
+    for (unsigned int i = start; i < end; i++) {
+        free_slots[i >> 5] |= 1u << (i & 31);
+    }
+}
+
+void array_unmark_free_slot(uint32_t *free_slots, unsigned int index)
+{
+    free_slots[index >> 5] &= ~(1u << (index & 31));
+}
+
+unsigned int array_next_free_slot(const uint32_t *free_slots, unsigned int start, unsigned int end)
+{
+    if (start >= end) {
+        return end;
+    }
+    unsigned int word = start >> 5;
+    uint32_t bits = free_slots[word] & (0xffffffffu << (start & 31));
+    unsigned int last_word = (end - 1) >> 5;
+    while (!bits) {
+        if (++word > last_word) {
+            return end;
+        }
+        bits = free_slots[word];
+    }
+    unsigned int index = word << 5;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        index++;
+    }
+    return index < end ? index : end;
+}
@@ -1,6 +1,7 @@
 #ifndef CORE_ARRAY_H
 #define CORE_ARRAY_H
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -17,6 +18,8 @@ struct { \
     unsigned int bit_offset; \
     void (*constructor)(T *, unsigned int); \
     int (*in_use)(const T *); \
+    uint32_t *free_slots; \
+    unsigned int free_slot_words; \
 }
 
 /**
@@ -26,6 +29,7 @@ struct { \
 #define array_clear(a) \
 ( \
     array_free((void **)(a).items, (a).blocks), \
+    free((a).free_slots), \
     memset(&(a), 0, sizeof(a)) \
 )
 
@@ -53,6 +57,32 @@ struct { \
     array_create_blocks(a, 1) \
 )
 
+/**
+ * Enables the free slot bitmap for an array that has an in_use callback, so that new items are found without
+ * checking every used item. Must be called again after every array_init.
+ * When enabled, array_release_item MUST be called whenever an item stops being in use, otherwise its slot
+ * will not be reused. New items are still placed at the first free slot, so item ids are the same as without it.
+ * @param a The array structure
+ * @return Whether memory was properly allocated.
+ */
+#define array_enable_free_slots(a) \
+( \
+    array_grow_free_slots(&(a).free_slots, &(a).free_slot_words, ((a).block_offset + 1) * (a).blocks) && \
+    (array_mark_free_slots((a).free_slots, 0, (a).size), 1) \
+)
+
+/**
+ * Tells the array that an item is no longer in use. Only needed if array_enable_free_slots was called.
+ * @param a The array structure
+ * @param index The index of the item that was released
+ */
+#define array_release_item(a, index) \
+{ \
+    if ((a).free_slots && (index) < (a).size) { \
+        array_mark_free_slots((a).free_slots, index, (index) + 1); \
+    } \
+}
+
 /**
  * Creates a new item for the array, either by finding an available empty item or by expanding the array.
  * @param a The array structure
@@ -63,16 +93,7 @@ struct { \
     ptr = 0; \
     int error = 0; \
     if ((a).in_use) { \
-        for (unsigned int array_index = 0; array_index < (a).size; array_index++) { \
-            if (!(a).in_use(array_item(a, array_index))) { \
-                ptr = array_item(a, array_index); \
-                memset(ptr, 0, sizeof(**(a).items)); \
-                if ((a).constructor) { \
-                    (a).constructor(ptr, array_index); \
-                } \
-                break; \
-            } \
-        } \
+        array_find_free_item(a, 0, ptr); \
     } \
     if (!error && !ptr) { \
         ptr = array_advance(a); \
@@ -97,16 +118,7 @@ struct { \
         } \
     } \
     if (!error && (a).in_use) { \
-        for (unsigned int array_index = index; array_index < (a).size; array_index++) { \
-            if (!(a).in_use(array_item(a, array_index))) { \
-                ptr = array_item(a, array_index); \
-                memset(ptr, 0, sizeof(**(a).items)); \
-                if ((a).constructor) { \
-                    (a).constructor(ptr, array_index); \
-                } \
-                break; \
-            } \
-        } \
+        array_find_free_item(a, index, ptr); \
     } \
     if (!error && !ptr) { \
         ptr = array_advance(a); \
@@ -130,6 +142,9 @@ struct { \
         memset(array_item(a, (a).size - 1), 0, sizeof(**(a).items)); \
         (a).size--; \
     } \
+    if ((a).free_slots) { \
+        array_mark_free_slots((a).free_slots, index, (a).size); \
+    } \
 }
 
 /**
@@ -235,6 +250,9 @@ struct { \
             } \
             (a).size -= items_to_move; \
         } \
+        if ((a).free_slots) { \
+            array_mark_free_slots((a).free_slots, 0, (a).size); \
+        } \
     } \
 }
 
@@ -259,6 +277,7 @@ struct { \
 ( \
     memset(array_item(a, (a).size), 0, sizeof(**(a).items)), \
     (a).constructor ? (a).constructor(array_item(a, (a).size), (a).size) : (void) 0, \
+    (a).free_slots ? array_mark_free_slots((a).free_slots, (a).size, (a).size + 1) : (void) 0, \
     (a).size++, \
     array_item(a, (a).size - 1) \
 )
@@ -268,9 +287,37 @@ struct { \
  */
 #define array_create_blocks(a, num_blocks) \
 ( \
-    array_add_blocks((void ***)&(a).items, &(a).blocks, (a).block_offset + 1, sizeof(**(a).items), num_blocks) \
+    array_add_blocks((void ***)&(a).items, &(a).blocks, (a).block_offset + 1, sizeof(**(a).items), num_blocks) && \
+    (!(a).free_slots || \
+        array_grow_free_slots(&(a).free_slots, &(a).free_slot_words, ((a).block_offset + 1) * (a).blocks)) \
 )
 
+/**
+ * This definition is private and should not be used
+ * Finds the first unused item from index onwards. Slots marked as free may have been reused since,
+ * so each candidate is checked and its mark is dropped if it is in use.
+ */
+#define array_find_free_item(a, index, ptr) \
+{ \
+    unsigned int array_index = (a).free_slots ? array_next_free_slot((a).free_slots, index, (a).size) : (index); \
+    while (array_index < (a).size) { \
+        if (!(a).in_use(array_item(a, array_index))) { \
+            ptr = array_item(a, array_index); \
+            memset(ptr, 0, sizeof(**(a).items)); \
+            if ((a).constructor) { \
+                (a).constructor(ptr, array_index); \
+            } \
+            break; \
+        } \
+        if ((a).free_slots) { \
+            array_unmark_free_slot((a).free_slots, array_index); \
+            array_index = array_next_free_slot((a).free_slots, array_index + 1, (a).size); \
+        } else { \
+            array_index++; \
+        } \
+    } \
+}
+
 /**
  * This function is private and should not be used
  */
@@ -281,6 +328,14 @@ int array_add_blocks(void ***data, unsigned int *blocks, unsigned int items_per_
  */
 void array_free(void **data, unsigned int blocks);
 
+/**
+ * These functions are private and should not be used
+ */
+int array_grow_free_slots(uint32_t **free_slots, unsigned int *words, unsigned int capacity);
+void array_mark_free_slots(uint32_t *free_slots, unsigned int start, unsigned int end);
+void array_unmark_free_slot(uint32_t *free_slots, unsigned int index);
+unsigned int array_next_free_slot(const uint32_t *free_slots, unsigned int start, unsigned int end);
+
 /**
  * Private helper compile-time functions for finding the next power of two into which a number fits
  */
@@ -74,6 +74,8 @@ static const char *ini_keys[] = {
     "gameplay_change_nonmilitary_gates_allow_walkers",
     "ui_show_speedrun_info",
     "ui_show_desirability_range",
+    "spread_monthly_map_updates",
+    "screen_batch_sprites",
 };
 
 static const char *ini_string_keys[] = {
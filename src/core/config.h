@@ -64,6 +64,8 @@ typedef enum {
     CONFIG_GP_CH_GATES_DEFAULT_TO_PASS_ALL_WALKERS,
     CONFIG_UI_SHOW_SPEEDRUN_INFO,    
     CONFIG_UI_SHOW_DESIRABILITY_RANGE,
+    CONFIG_GENERAL_SPREAD_MONTHLY_MAP_UPDATES,
+    CONFIG_SCREEN_BATCH_SPRITES,
     CONFIG_MAX_ENTRIES
 } config_key;
 
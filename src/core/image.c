@@ -2,10 +2,13 @@
 
 #include "assets/assets.h"
 #include "core/buffer.h"
+#include "core/dir.h"
 #include "core/file.h"
+#include "core/image_convert.h"
 #include "core/image_packer.h"
 #include "core/io.h"
 #include "core/log.h"
+#include "core/zlib_helper.h"
 #include "graphics/font.h"
 #include "graphics/renderer.h"
 
@@ -43,6 +46,16 @@
 
 #define IMAGE_TYPE_ISOMETRIC 30
 
+// Bump when the conversion or the packing of the main images changes
+#define ATLAS_CACHE_VERSION 1
+#define ATLAS_CACHE_MAGIC "AUGA"
+#define ATLAS_CACHE_EXTENSION "atlas"
+#define ATLAS_CACHE_KEY_SIZE 28
+#define ATLAS_CACHE_HEADER_SIZE (ATLAS_CACHE_KEY_SIZE + 12)
+#define ATLAS_CACHE_IMAGE_SIZE 36
+#define ATLAS_CACHE_ENTRIES_SIZE (IMAGE_MAIN_ENTRIES * (2 * ATLAS_CACHE_IMAGE_SIZE + 1))
+#define ATLAS_CACHE_MAX_IMAGES 256
+
 enum {
     NO_EXTRA_FONT = 0,
     FULL_CHARSET_IN_FONT = 1,
@@ -60,6 +73,14 @@ typedef struct {
     void *buffer;
 } image_draw_data;
 
+typedef struct {
+    uint32_t index_hash;
+    uint32_t data_hash;
+    int data_size;
+    int max_image_width;
+    int max_image_height;
+} atlas_cache_key;
+
 typedef struct {
     int width;
     int height;
@@ -329,6 +350,23 @@ static int prepare_images(buffer *buf, image *images, image_draw_data *draw_data
     return 1;
 }
 
+static void prepare_external_draw_data(const image *images, const image_draw_data *draw_datas, int num_images)
+{
+    for (int i = 1; i < num_images; i++) {
+        const image *img = &images[i];
+        if (!image_is_external(img)) {
+            continue;
+        }
+        image_draw_data *external_data = &data.external_draw_data[img->atlas.id & IMAGE_ATLAS_BIT_MASK];
+        memcpy(external_data, &draw_datas[i], sizeof(image_draw_data));
+        if (!external_data->offset) {
+            external_data->offset = 1;
+        }
+        external_data->width = img->original.width;
+        external_data->height = img->original.height;
+    }
+}
+
 static void convert_compressed(buffer *buf, int width, int height, int x_offset, int y_offset,
     int buf_length, color_t *dst, int dst_width);
 
@@ -349,13 +387,6 @@ static int crop_and_pack_images(buffer *buf, image *images, image_draw_data *dra
         image_draw_data *draw_data = &draw_datas[i];
 
         if (image_is_external(img)) {
-            image_draw_data *external_data = &data.external_draw_data[img->atlas.id & IMAGE_ATLAS_BIT_MASK];
-            memcpy(external_data, draw_data, sizeof(image_draw_data));
-            if (!external_data->offset) {
-                external_data->offset = 1;
-            }
-            external_data->width = img->original.width;
-            external_data->height = img->original.height;
             continue;
         }
         draw_data->offset = offset;
@@ -427,15 +458,28 @@ static color_t to_32_bit(uint16_t c)
         ((c & 0x1f) << 3) | ((c & 0x1c) >> 2);
 }
 
+static void read_pixels(buffer *buf, color_t *dst, int count, int resolve_transparency)
+{
+    size_t available = buf->index < buf->size ? (buf->size - buf->index) / 2 : 0;
+    int run = (size_t) count < available ? count : (int) available;
+    if (resolve_transparency) {
+        image_convert_555_with_transparency(&buf->data[buf->index], dst, run);
+    } else {
+        image_convert_555(&buf->data[buf->index], dst, run);
+    }
+    buffer_skip(buf, 2 * run);
+    // Pixels beyond the end of the data go through the buffer so it is flagged as overflowing
+    for (int i = run; i < count; i++) {
+        color_t color = to_32_bit(buffer_read_u16(buf));
+        dst[i] = resolve_transparency && color == COLOR_SG2_TRANSPARENT ? ALPHA_TRANSPARENT : color;
+    }
+}
+
 static void convert_uncompressed(buffer *buf, int width, int height, int x_offset, int y_offset,
     color_t *dst, int dst_width)
 {
     for (int y = 0; y < height; y++) {
-        color_t *pixel = &dst[(y_offset + y) * dst_width + x_offset];
-        for (int x = 0; x < width; x++) {
-            color_t color = to_32_bit(buffer_read_u16(buf));
-            pixel[x] = color == COLOR_SG2_TRANSPARENT ? ALPHA_TRANSPARENT : color;
-        }
+        read_pixels(buf, &dst[(y_offset + y) * dst_width + x_offset], width, 1);
     }
 }
 
@@ -451,6 +495,9 @@ static void copy_compressed(const image *img, image_draw_data *draw_data, color_
 static void convert_compressed(buffer *buf, int width, int height, int x_offset, int y_offset,
     int buf_length, color_t *dst, int dst_width)
 {
+    if (width <= 0) {
+        return;
+    }
     int y = 0;
     int x = 0;
     while (buf_length > 0) {
@@ -469,10 +516,12 @@ static void convert_compressed(buffer *buf, int width, int height, int x_offset,
             }
             buf_length -= 2;
         } else {
-            // control = number of concrete pixels
-            for (int i = 0; i < control; i++) {
-                dst[(y + y_offset) * dst_width + x_offset + x] = to_32_bit(buffer_read_u16(buf));
-                x++;
+            // control = number of concrete pixels, which may continue on the next rows
+            for (int remaining = control; remaining > 0;) {
+                int run = remaining < width - x ? remaining : width - x;
+                read_pixels(buf, &dst[(y + y_offset) * dst_width + x_offset + x], run, 0);
+                remaining -= run;
+                x += run;
                 if (x >= width) {
                     y++;
                     if (y >= height) {
@@ -491,11 +540,8 @@ static void convert_footprint_tile(buffer *buf, const image *img,
 {
     for (int y = 0; y < FOOTPRINT_HEIGHT; y++) {
         int x_start = FOOTPRINT_X_START_PER_HEIGHT[y];
-        int x_max = FOOTPRINT_WIDTH - x_start;
-        for (int x = x_start; x < x_max; x++) {
-            dst[(y + y_offset + img->atlas.y_offset) * dst_width + img->atlas.x_offset + x + x_offset] =
-                to_32_bit(buffer_read_u16(buf));
-        }
+        color_t *row = &dst[(y + y_offset + img->atlas.y_offset) * dst_width + img->atlas.x_offset + x_offset];
+        read_pixels(buf, &row[x_start], FOOTPRINT_WIDTH - 2 * x_start, 0);
     }
 }
 
@@ -613,6 +659,168 @@ static void release_external_buffers(void)
     }
 }
 
+static void write_cached_image_entry(buffer *buf, const image *img)
+{
+    buffer_write_i32(buf, img->x_offset);
+    buffer_write_i32(buf, img->y_offset);
+    buffer_write_i32(buf, img->width);
+    buffer_write_i32(buf, img->height);
+    buffer_write_i32(buf, img->original.width);
+    buffer_write_i32(buf, img->original.height);
+    buffer_write_i32(buf, img->atlas.id);
+    buffer_write_i32(buf, img->atlas.x_offset);
+    buffer_write_i32(buf, img->atlas.y_offset);
+}
+
+static void read_cached_image_entry(buffer *buf, image *img)
+{
+    img->x_offset = buffer_read_i32(buf);
+    img->y_offset = buffer_read_i32(buf);
+    img->width = buffer_read_i32(buf);
+    img->height = buffer_read_i32(buf);
+    img->original.width = buffer_read_i32(buf);
+    img->original.height = buffer_read_i32(buf);
+    img->atlas.id = buffer_read_i32(buf);
+    img->atlas.x_offset = buffer_read_i32(buf);
+    img->atlas.y_offset = buffer_read_i32(buf);
+}
+
+static void write_atlas_cache_key(buffer *buf, const atlas_cache_key *key)
+{
+    buffer_write_raw(buf, ATLAS_CACHE_MAGIC, 4);
+    buffer_write_i32(buf, ATLAS_CACHE_VERSION);
+    buffer_write_u32(buf, key->index_hash);
+    buffer_write_u32(buf, key->data_hash);
+    buffer_write_i32(buf, key->data_size);
+    buffer_write_i32(buf, key->max_image_width);
+    buffer_write_i32(buf, key->max_image_height);
+}
+
+static const char *get_atlas_cache_filename(const char *filename_idx)
+{
+    static char filename[FILE_NAME_MAX];
+    snprintf(filename, FILE_NAME_MAX, "%s", filename_idx);
+    file_remove_extension(filename);
+    file_append_extension(filename, ATLAS_CACHE_EXTENSION, FILE_NAME_MAX);
+    return dir_append_location(filename, PATH_LOCATION_CONFIG);
+}
+
+static const image_atlas_data *load_atlas_from_cache(const char *filename_idx, const atlas_cache_key *key)
+{
+    FILE *fp = file_open(get_atlas_cache_filename(filename_idx), "rb");
+    if (!fp) {
+        return 0;
+    }
+    uint8_t header_data[ATLAS_CACHE_HEADER_SIZE];
+    uint8_t expected_key_data[ATLAS_CACHE_KEY_SIZE];
+    buffer buf;
+    if (fread(header_data, 1, ATLAS_CACHE_HEADER_SIZE, fp) != ATLAS_CACHE_HEADER_SIZE) {
+        file_close(fp);
+        return 0;
+    }
+    buffer_init(&buf, expected_key_data, ATLAS_CACHE_KEY_SIZE);
+    write_atlas_cache_key(&buf, key);
+    buffer_init(&buf, header_data, ATLAS_CACHE_HEADER_SIZE);
+    buffer_skip(&buf, ATLAS_CACHE_KEY_SIZE);
+    int num_images = buffer_read_i32(&buf);
+    int last_width = buffer_read_i32(&buf);
+    int last_height = buffer_read_i32(&buf);
+    if (memcmp(header_data, expected_key_data, ATLAS_CACHE_KEY_SIZE) != 0 ||
+        num_images <= 0 || num_images > ATLAS_CACHE_MAX_IMAGES) {
+        file_close(fp);
+        return 0;
+    }
+    uint8_t *entries = malloc(ATLAS_CACHE_ENTRIES_SIZE);
+    if (!entries || fread(entries, 1, ATLAS_CACHE_ENTRIES_SIZE, fp) != ATLAS_CACHE_ENTRIES_SIZE) {
+        free(entries);
+        file_close(fp);
+        return 0;
+    }
+    // The pixels are read straight into the atlas buffers of the renderer
+    const image_atlas_data *atlas_data = graphics_renderer()->prepare_image_atlas(ATLAS_MAIN,
+        num_images, last_width, last_height);
+    if (!atlas_data) {
+        free(entries);
+        file_close(fp);
+        return 0;
+    }
+    for (int i = 0; i < atlas_data->num_images; i++) {
+        size_t pixels = (size_t) atlas_data->image_widths[i] * atlas_data->image_heights[i];
+        if (fread(atlas_data->buffers[i], sizeof(color_t), pixels, fp) != pixels) {
+            free(entries);
+            file_close(fp);
+            return 0;
+        }
+    }
+    file_close(fp);
+
+    buffer_init(&buf, entries, ATLAS_CACHE_ENTRIES_SIZE);
+    for (int i = 0; i < IMAGE_MAIN_ENTRIES; i++) {
+        image *img = &data.main[i];
+        read_cached_image_entry(&buf, img);
+        int has_top = buffer_read_u8(&buf);
+        if (img->top && !has_top) {
+            // The top was cropped away completely
+            free(img->top);
+            img->top = 0;
+        }
+        if (img->top) {
+            read_cached_image_entry(&buf, img->top);
+        } else {
+            buffer_skip(&buf, ATLAS_CACHE_IMAGE_SIZE);
+        }
+    }
+    free(entries);
+    return atlas_data;
+}
+
+static void save_atlas_to_cache(const char *filename_idx, const atlas_cache_key *key,
+    const image_atlas_data *atlas_data, int last_width, int last_height)
+{
+    uint8_t *entries = malloc(ATLAS_CACHE_ENTRIES_SIZE);
+    if (!entries) {
+        return;
+    }
+    uint8_t header_data[ATLAS_CACHE_HEADER_SIZE];
+    buffer buf;
+    buffer_init(&buf, header_data, ATLAS_CACHE_HEADER_SIZE);
+    write_atlas_cache_key(&buf, key);
+    buffer_write_i32(&buf, atlas_data->num_images);
+    buffer_write_i32(&buf, last_width);
+    buffer_write_i32(&buf, last_height);
+
+    static const image no_top;
+    buffer_init(&buf, entries, ATLAS_CACHE_ENTRIES_SIZE);
+    for (int i = 0; i < IMAGE_MAIN_ENTRIES; i++) {
+        const image *img = &data.main[i];
+        write_cached_image_entry(&buf, img);
+        buffer_write_u8(&buf, img->top != 0);
+        write_cached_image_entry(&buf, img->top ? img->top : &no_top);
+    }
+
+    char filename[FILE_NAME_MAX];
+    // Room for the ".tmp" suffix, so the temporary name is never cut
+    char temp_filename[FILE_NAME_MAX + 4];
+    snprintf(filename, FILE_NAME_MAX, "%s", get_atlas_cache_filename(filename_idx));
+    snprintf(temp_filename, sizeof(temp_filename), "%s.tmp", filename);
+    FILE *fp = file_open(temp_filename, "wb");
+    if (!fp) {
+        free(entries);
+        return;
+    }
+    int ok = fwrite(header_data, 1, ATLAS_CACHE_HEADER_SIZE, fp) == ATLAS_CACHE_HEADER_SIZE &&
+        fwrite(entries, 1, ATLAS_CACHE_ENTRIES_SIZE, fp) == ATLAS_CACHE_ENTRIES_SIZE;
+    for (int i = 0; ok && i < atlas_data->num_images; i++) {
+        size_t pixels = (size_t) atlas_data->image_widths[i] * atlas_data->image_heights[i];
+        ok = fwrite(atlas_data->buffers[i], sizeof(color_t), pixels, fp) == pixels;
+    }
+    free(entries);
+    if (!file_close(fp) || !ok || !file_rename(temp_filename, filename)) {
+        log_error("Unable to write image cache", filename, 0);
+        file_remove(temp_filename);
+    }
+}
+
 int image_load_climate(int climate_id, int is_editor, int force_reload, int keep_atlas_buffers)
 {
     if (climate_id == data.current_climate && is_editor == data.is_editor && !force_reload &&
@@ -645,6 +853,11 @@ int image_load_climate(int climate_id, int is_editor, int force_reload, int keep
     memset(data.main, 0, sizeof(data.main));
     memset(draw_data, 0, IMAGE_MAIN_ENTRIES * sizeof(image_draw_data));
 
+    atlas_cache_key cache_key;
+    cache_key.index_hash = zlib_helper_adler32(tmp_data, MAIN_INDEX_SIZE);
+    cache_key.max_image_width = data.max_image_width;
+    cache_key.max_image_height = data.max_image_height;
+
     buffer buf;
     buffer_init(&buf, tmp_data, HEADER_SIZE);
     read_header(&buf);
@@ -654,6 +867,7 @@ int image_load_climate(int climate_id, int is_editor, int force_reload, int keep
         free(draw_data);
         return 0;
     }
+    prepare_external_draw_data(data.main, draw_data, IMAGE_MAIN_ENTRIES);
 
     int data_size = io_read_file_into_buffer(filename_bmp, MAY_BE_LOCALIZED, tmp_data, MAIN_DATA_SIZE);
     if (!data_size) {
@@ -665,32 +879,41 @@ int image_load_climate(int climate_id, int is_editor, int force_reload, int keep
         return 0;
     }
 
-    buffer_init(&buf, tmp_data, data_size);
-    if (!crop_and_pack_images(&buf, data.main, draw_data, IMAGE_MAIN_ENTRIES, ATLAS_MAIN)) {
-        free(tmp_data);
-        free_draw_data(draw_data, IMAGE_MAIN_ENTRIES);
-        release_external_buffers();
-        free(data.external_draw_data);
-        data.external_draw_data = 0;
-        return 0;
-    }
+    cache_key.data_hash = zlib_helper_adler32(tmp_data, data_size);
+    cache_key.data_size = data_size;
 
-    const image_atlas_data *atlas_data = graphics_renderer()->prepare_image_atlas(ATLAS_MAIN,
-        data.packer.result.images_needed, data.packer.result.last_image_width, data.packer.result.last_image_height);
+    // The cache holds the converted and packed images, so a warm start skips both steps
+    const image_atlas_data *atlas_data = load_atlas_from_cache(filename_idx, &cache_key);
     if (!atlas_data) {
-        image_packer_free(&data.packer);
-        free(tmp_data);
-        free_draw_data(draw_data, IMAGE_MAIN_ENTRIES);
-        release_external_buffers();
-        free(data.external_draw_data);
-        data.external_draw_data = 0;
-        return 0;
-    }
+        buffer_init(&buf, tmp_data, data_size);
+        if (!crop_and_pack_images(&buf, data.main, draw_data, IMAGE_MAIN_ENTRIES, ATLAS_MAIN)) {
+            free(tmp_data);
+            free_draw_data(draw_data, IMAGE_MAIN_ENTRIES);
+            release_external_buffers();
+            free(data.external_draw_data);
+            data.external_draw_data = 0;
+            return 0;
+        }
 
-    convert_images(data.main, draw_data, IMAGE_MAIN_ENTRIES, &buf, atlas_data);
+        atlas_data = graphics_renderer()->prepare_image_atlas(ATLAS_MAIN, data.packer.result.images_needed,
+            data.packer.result.last_image_width, data.packer.result.last_image_height);
+        if (!atlas_data) {
+            image_packer_free(&data.packer);
+            free(tmp_data);
+            free_draw_data(draw_data, IMAGE_MAIN_ENTRIES);
+            release_external_buffers();
+            free(data.external_draw_data);
+            data.external_draw_data = 0;
+            return 0;
+        }
+
+        convert_images(data.main, draw_data, IMAGE_MAIN_ENTRIES, &buf, atlas_data);
+        make_plain_fonts_white(data.main, atlas_data, image_group(GROUP_FONT));
+        save_atlas_to_cache(filename_idx, &cache_key, atlas_data,
+            data.packer.result.last_image_width, data.packer.result.last_image_height);
+    }
     free_draw_data(draw_data, IMAGE_MAIN_ENTRIES);
     free(tmp_data);
-    make_plain_fonts_white(data.main, atlas_data, image_group(GROUP_FONT));
     if (!keep_atlas_buffers) {
         assets_init(data.is_editor != is_editor, atlas_data->buffers, atlas_data->image_widths);
     }
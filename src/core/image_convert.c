@@ -0,0 +1,108 @@
+#include "image_convert.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && \
+    (!defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define USE_NEON
+#include <arm_neon.h>
+#endif
+
+static color_t to_32_bit(uint16_t c)
+{
+    return ALPHA_OPAQUE |
+        ((c & 0x7c00) << 9) | ((c & 0x7000) << 4) |
+        ((c & 0x3e0) << 6) | ((c & 0x380) << 1) |
+        ((c & 0x1f) << 3) | ((c & 0x1c) >> 2);
+}
+
+static void convert_scalar(const uint8_t *src, color_t *dst, int count, int resolve_transparency)
+{
+    for (int i = 0; i < count; i++, src += 2) {
+        color_t color = to_32_bit((uint16_t) (src[0] | (src[1] << 8)));
+        dst[i] = resolve_transparency && color == COLOR_SG2_TRANSPARENT ? ALPHA_TRANSPARENT : color;
+    }
+}
+
+#if defined(USE_SSE2)
+
+// Expands each 5-bit channel to 8 bits by repeating its top bits, like to_32_bit
+static int convert_vector(const uint8_t *src, color_t *dst, int count, int resolve_transparency)
+{
+    const __m128i mask_5_bits = _mm_set1_epi16(0x1f);
+    const __m128i alpha = _mm_set1_epi16((short) 0xff00);
+    const __m128i transparent = _mm_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    int i = 0;
+    for (; i + 8 <= count; i += 8, src += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *) src);
+        __m128i r = _mm_and_si128(_mm_srli_epi16(c, 10), mask_5_bits);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(c, 5), mask_5_bits);
+        __m128i b = _mm_and_si128(c, mask_5_bits);
+        r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+        g = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
+        b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+        __m128i green_blue = _mm_or_si128(_mm_slli_epi16(g, 8), b);
+        __m128i alpha_red = _mm_or_si128(alpha, r);
+        __m128i low = _mm_unpacklo_epi16(green_blue, alpha_red);
+        __m128i high = _mm_unpackhi_epi16(green_blue, alpha_red);
+        if (resolve_transparency) {
+            low = _mm_andnot_si128(_mm_cmpeq_epi32(low, transparent), low);
+            high = _mm_andnot_si128(_mm_cmpeq_epi32(high, transparent), high);
+        }
+        _mm_storeu_si128((__m128i *) &dst[i], low);
+        _mm_storeu_si128((__m128i *) &dst[i + 4], high);
+    }
+    return i;
+}
+
+#elif defined(USE_NEON)
+
+// Expands each 5-bit channel to 8 bits by repeating its top bits, like to_32_bit
+static int convert_vector(const uint8_t *src, color_t *dst, int count, int resolve_transparency)
+{
+    const uint16x8_t mask_5_bits = vdupq_n_u16(0x1f);
+    const uint16x8_t alpha = vdupq_n_u16(0xff00);
+    const uint32x4_t transparent = vdupq_n_u32(COLOR_SG2_TRANSPARENT);
+    int i = 0;
+    for (; i + 8 <= count; i += 8, src += 16) {
+        uint16x8_t c = vreinterpretq_u16_u8(vld1q_u8(src));
+        uint16x8_t r = vandq_u16(vshrq_n_u16(c, 10), mask_5_bits);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(c, 5), mask_5_bits);
+        uint16x8_t b = vandq_u16(c, mask_5_bits);
+        r = vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2));
+        g = vorrq_u16(vshlq_n_u16(g, 3), vshrq_n_u16(g, 2));
+        b = vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2));
+        uint16x8x2_t pixels = vzipq_u16(vorrq_u16(vshlq_n_u16(g, 8), b), vorrq_u16(alpha, r));
+        uint32x4_t low = vreinterpretq_u32_u16(pixels.val[0]);
+        uint32x4_t high = vreinterpretq_u32_u16(pixels.val[1]);
+        if (resolve_transparency) {
+            low = vbicq_u32(low, vceqq_u32(low, transparent));
+            high = vbicq_u32(high, vceqq_u32(high, transparent));
+        }
+        vst1q_u32(&dst[i], low);
+        vst1q_u32(&dst[i + 4], high);
+    }
+    return i;
+}
+
+#else
+
+static int convert_vector(const uint8_t *src, color_t *dst, int count, int resolve_transparency)
+{
+    return 0;
+}
+
+#endif
+
+void image_convert_555(const uint8_t *src, color_t *dst, int count)
+{
+    int converted = convert_vector(src, dst, count, 0);
+    convert_scalar(src + 2 * converted, dst + converted, count - converted, 0);
+}
+
+void image_convert_555_with_transparency(const uint8_t *src, color_t *dst, int count)
+{
+    int converted = convert_vector(src, dst, count, 1);
+    convert_scalar(src + 2 * converted, dst + converted, count - converted, 1);
+}
@@ -0,0 +1,31 @@
+#ifndef CORE_IMAGE_CONVERT_H
+#define CORE_IMAGE_CONVERT_H
+
+#include "graphics/color.h"
+
+#include <stdint.h>
+
+/**
+ * @file
+ * Conversion of the 16-bit pixels of the original game images.
+ * Uses SSE2 or NEON when the compiler targets them, with a portable fallback.
+ */
+
+/**
+ * Converts a run of little-endian RGB555 pixels to 32-bit colors
+ * @param src Source pixels, two bytes each, no alignment required
+ * @param dst Destination colors
+ * @param count Number of pixels
+ */
+void image_convert_555(const uint8_t *src, color_t *dst, int count);
+
+/**
+ * Converts a run of little-endian RGB555 pixels to 32-bit colors,
+ * turning the pixels with the transparent SG2 color into fully transparent pixels
+ * @param src Source pixels, two bytes each, no alignment required
+ * @param dst Destination colors
+ * @param count Number of pixels
+ */
+void image_convert_555_with_transparency(const uint8_t *src, color_t *dst, int count);
+
+#endif // CORE_IMAGE_CONVERT_H
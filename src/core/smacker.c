@@ -30,6 +30,10 @@
 // #define BLOCK_VOID 2 - not supported
 #define BLOCK_SOLID 3
 
+// Number of bits resolved at once by the huffman lookup tables
+#define TREE8_TABLE_BITS 8
+#define TREE16_TABLE_BITS 12
+
 typedef struct {
     const uint8_t *data;
     size_t length;
@@ -43,9 +47,15 @@ typedef struct huffnode8_t {
     uint8_t value;
 } huffnode8;
 
+typedef struct {
+    huffnode8 *node;
+    int length;
+} huffentry8;
+
 typedef struct hufftree8_t {
     huffnode8 nodes[512];
     int size;
+    huffentry8 table[1 << TREE8_TABLE_BITS];
 } hufftree8;
 
 typedef struct huffnode16_t {
@@ -54,8 +64,19 @@ typedef struct huffnode16_t {
     uint16_t value;
 } huffnode16;
 
+/**
+ * Points to the node reached after reading 'length' bits: the leaf itself for short codes,
+ * otherwise the node where the bit-by-bit walk continues.
+ * Leaves are referenced instead of their values because the escape leaves change value while decoding.
+ */
+typedef struct {
+    huffnode16 *node;
+    int length;
+} huffentry16;
+
 typedef struct hufftree16_t {
     huffnode16 *root;
+    huffentry16 *table;
     hufftree8 *low;
     hufftree8 *high;
     uint16_t escape_codes[3];
@@ -186,6 +207,34 @@ static inline uint8_t read_byte(bitstream *bs)
     return value;
 }
 
+static inline unsigned int peek_bits(const bitstream *bs, int count)
+{
+    // Bits past the end of the stream read as zero, like in read_bit()
+    size_t index = bs->index;
+    uint32_t value;
+    if (index + 3 <= bs->length) {
+        value = bs->data[index] | (bs->data[index + 1] << 8) | (bs->data[index + 2] << 16);
+    } else {
+        value = 0;
+        for (int i = 0; i < 3 && index + i < bs->length; i++) {
+            value |= bs->data[index + i] << (8 * i);
+        }
+    }
+    return (value >> bs->bit_index) & ((1 << count) - 1);
+}
+
+static inline void skip_bits(bitstream *bs, int count)
+{
+    int bits = bs->bit_index + count;
+    bs->index += bits >> 3;
+    bs->bit_index = bits & 7;
+    if (bs->index >= bs->length) {
+        // read_bit() stops at the end of the stream
+        bs->index = bs->length;
+        bs->bit_index = 0;
+    }
+}
+
 // 8-bit huffman tree functions
 
 static huffnode8 *build_tree8_nodes(bitstream *bs, hufftree8 *tree)
@@ -202,6 +251,20 @@ static huffnode8 *build_tree8_nodes(bitstream *bs, hufftree8 *tree)
     return node;
 }
 
+static void fill_table8(hufftree8 *tree, huffnode8 *node, unsigned int code, int length)
+{
+    if (node->is_leaf || length == TREE8_TABLE_BITS) {
+        // Bits are read from the lowest bit up, so every table index ending in this code maps to the node
+        for (unsigned int i = code; i < (1 << TREE8_TABLE_BITS); i += 1 << length) {
+            tree->table[i].node = node;
+            tree->table[i].length = length;
+        }
+    } else {
+        fill_table8(tree, node->b[0], code, length + 1);
+        fill_table8(tree, node->b[1], code | (1 << length), length + 1);
+    }
+}
+
 static hufftree8 *create_tree8(bitstream *bs)
 {
     if (read_bit(bs)) {
@@ -216,6 +279,7 @@ static hufftree8 *create_tree8(bitstream *bs)
             free(tree);
             return NULL;
         }
+        fill_table8(tree, &tree->nodes[0], 0, 0);
         return tree;
     } else {
         log_info("SMK: WARN: no 8-bit tree found", 0, 0);
@@ -230,7 +294,9 @@ static void free_tree8(hufftree8 *tree)
 
 static uint8_t lookup_tree8(bitstream *bs, hufftree8 *tree)
 {
-    huffnode8 *node = &tree->nodes[0];
+    const huffentry8 *entry = &tree->table[peek_bits(bs, TREE8_TABLE_BITS)];
+    skip_bits(bs, entry->length);
+    huffnode8 *node = entry->node;
     while (!node->is_leaf) {
         node = node->b[read_bit(bs)];
     }
@@ -263,6 +329,7 @@ static void free_tree16(hufftree16 *tree)
         }
     }
     free_node16(tree->root);
+    free(tree->table);
     free_tree8(tree->low);
     free_tree8(tree->high);
     free(tree);
@@ -304,6 +371,19 @@ static huffnode16 *build_tree16_nodes(bitstream *bs, hufftree16 *tree)
     return node;
 }
 
+static void fill_table16(hufftree16 *tree, huffnode16 *node, unsigned int code, int length)
+{
+    if (node->is_leaf || length == TREE16_TABLE_BITS) {
+        for (unsigned int i = code; i < (1 << TREE16_TABLE_BITS); i += 1 << length) {
+            tree->table[i].node = node;
+            tree->table[i].length = length;
+        }
+    } else {
+        fill_table16(tree, node->b[0], code, length + 1);
+        fill_table16(tree, node->b[1], code | (1 << length), length + 1);
+    }
+}
+
 static hufftree16 *create_tree16(bitstream *bs, hufftree8 *low, hufftree8 *high)
 {
     hufftree16 *tree = (hufftree16 *) clear_malloc(sizeof(hufftree16));
@@ -336,6 +416,13 @@ static hufftree16 *create_tree16(bitstream *bs, hufftree8 *low, hufftree8 *high)
             tree->escape_nodes[i]->value = 0;
         }
     }
+    tree->table = (huffentry16 *) malloc(sizeof(huffentry16) << TREE16_TABLE_BITS);
+    if (!tree->table) {
+        log_error("SMK: no memory for 16-bit tree table", 0, 0);
+        free_tree16(tree);
+        return NULL;
+    }
+    fill_table16(tree, tree->root, 0, 0);
     return tree;
 }
 
@@ -353,7 +440,9 @@ static uint16_t lookup_tree16(bitstream *bs, hufftree16 *tree)
     if (!tree) {
         return 0;
     }
-    huffnode16 *node = tree->root;
+    const huffentry16 *entry = &tree->table[peek_bits(bs, TREE16_TABLE_BITS)];
+    skip_bits(bs, entry->length);
+    huffnode16 *node = entry->node;
     while (!node->is_leaf) {
         node = node->b[read_bit(bs)];
     }
@@ -706,6 +795,9 @@ static int decode_audio_track(smacker s, int track, uint8_t *data, int length)
         }
         s->frame_data.audio_len[track] = index;
     }
+    for (int i = 0; i < num_trees; i++) {
+        free_tree8(trees[i]);
+    }
     return 1;
 }
 
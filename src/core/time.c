@@ -1,6 +1,7 @@
 #include "core/time.h"
 
 static time_millis current_time;
+static time_micros (*micros_source)(void);
 
 time_millis time_get_millis(void)
 {
@@ -11,3 +12,13 @@ void time_set_millis(time_millis millis)
 {
     current_time = millis;
 }
+
+time_micros time_get_micros(void)
+{
+    return micros_source ? micros_source() : current_time * 1000;
+}
+
+void time_set_micros_source(time_micros (*source)(void))
+{
+    micros_source = source;
+}
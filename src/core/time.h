@@ -25,4 +25,22 @@ time_millis time_get_millis(void);
  */
 void time_set_millis(time_millis millis);
 
+/**
+ * Time in microsecond-precision, for profiling. Use only for time difference calculations.
+ */
+typedef uint64_t time_micros;
+
+/**
+ * Gets a high resolution timestamp from the source set by the platform.
+ * Falls back to the current milliseconds when no source has been set.
+ * @return Current time in microseconds
+ */
+time_micros time_get_micros(void);
+
+/**
+ * Sets the high resolution clock used by time_get_micros
+ * @param source Function returning the current time in microseconds
+ */
+void time_set_micros_source(time_micros (*source)(void));
+
 #endif // CORE_TIME_H
@@ -16,61 +16,36 @@ enum {
     PK_EOF = 773,
 };
 
-struct pk_token {
-    int stop;
-
-    const uint8_t *input_data;
-    int input_ptr;
-    int input_length;
-
-    uint8_t *output_data;
-    int output_ptr;
-    int output_length;
+struct pk_length_code {
+    uint8_t bits; // flag bit + length code bits
+    uint8_t extra_bits;
+    uint16_t base_value;
 };
 
-typedef int pk_input_func(uint8_t *buffer, int length, struct pk_token *token);
-typedef void pk_output_func(uint8_t *buffer, int length, struct pk_token *token);
-
-struct pk_comp_buffer {
-    pk_input_func *input_func;
-    pk_output_func *output_func;
-    struct pk_token *token;
-
-    int window_size;
-    int dictionary_size;
-    unsigned int copy_offset_extra_mask;
-    int current_output_bits_used;
-
-    uint8_t input_data[8708];
-    uint8_t output_data[2050];
-    int output_ptr;
-
-    uint16_t analyze_offset_table[2304];
-    uint16_t analyze_index[8708];
-    signed short long_matcher[518];
-
-    uint16_t codeword_values[774];
-    uint8_t codeword_bits[774];
+struct pk_offset_code {
+    uint8_t bits;
+    uint8_t index;
 };
 
 struct pk_decomp_buffer {
-    pk_input_func *input_func;
-    pk_output_func *output_func;
-    struct pk_token *token;
+    const uint8_t *input;
+    int input_length;
+    int input_ptr;
+    uint64_t bits; // lowest bit is the next bit in the stream
+    int bits_available;
+    // Bits that can still be used. PKWARE's decoder always keeps the next 8 bits buffered,
+    // so a stream counts as exhausted 8 bits before its actual end
+    int64_t bits_left;
+
+    uint8_t *output;
+    int output_length;
+    int output_ptr;
 
     int window_size;
     int dictionary_size;
-    uint16_t current_input_byte;
-    int current_input_bits_available;
 
-    int input_buffer_ptr;
-    int input_buffer_end;
-    int output_buffer_ptr;
-    uint8_t input_buffer[2048];
-    uint8_t output_buffer[8708]; // 2x 4096 (max dict size) + 516 for copying
-
-    uint8_t copy_offset_jump_table[256];
-    uint8_t copy_length_jump_table[256];
+    struct pk_length_code length_table[256];
+    struct pk_offset_code offset_table[256];
 };
 
 struct pk_copy_length_offset {
@@ -114,164 +89,179 @@ static const uint8_t pk_copy_length_extra_bits[16] = {
     0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8,
 };
 
-static void pk_memcpy(uint8_t *dst, const uint8_t *src, int length)
+static void pk_explode_construct_length_table(struct pk_length_code *table)
 {
-    for (int i = 0; i < length; i++) {
-        dst[i] = src[i];
+    for (int i = 15; i >= 0; i--) {
+        uint8_t bits = pk_copy_length_base_bits[i];
+        int code = pk_copy_length_base_code[i];
+        do {
+            table[code].bits = 1 + bits;
+            table[code].extra_bits = pk_copy_length_extra_bits[i];
+            table[code].base_value = pk_copy_length_base_value[i];
+            code += 1 << bits;
+        } while (code < 0x100);
     }
 }
 
-static void pk_explode_construct_jump_table(int size, const uint8_t *bits, const uint8_t *codes, uint8_t *jump)
+static void pk_explode_construct_offset_table(struct pk_offset_code *table)
 {
-    for (int i = size - 1; i >= 0; i--) {
-        uint8_t bit = bits[i];
-        int code = codes[i];
+    for (int i = 63; i >= 0; i--) {
+        uint8_t bits = pk_copy_offset_bits[i];
+        int code = pk_copy_offset_code[i];
         do {
-            jump[code] = (uint8_t) i;
-            code += 1 << bit;
+            table[code].bits = bits;
+            table[code].index = (uint8_t) i;
+            code += 1 << bits;
         } while (code < 0x100);
     }
 }
 
-static int pk_explode_set_bits_used(struct pk_decomp_buffer *buf, int num_bits)
+static inline void pk_explode_refill_bits(struct pk_decomp_buffer *buf)
 {
-    if (buf->current_input_bits_available >= num_bits) {
-        buf->current_input_bits_available -= num_bits;
-        buf->current_input_byte = (uint16_t) (buf->current_input_byte >> num_bits);
-        return 0;
+    if (buf->bits_available > 56) {
+        return;
     }
-    buf->current_input_byte = (uint16_t) (buf->current_input_byte >> buf->current_input_bits_available);
-    if (buf->input_buffer_ptr == buf->input_buffer_end) {
-        // Fill buffer
-        buf->input_buffer_ptr = 2048;
-        buf->input_buffer_end = buf->input_func(buf->input_buffer, buf->input_buffer_ptr, buf->token);
-        if (!buf->input_buffer_end) {
-            return 1;
+    if (buf->input_ptr + 8 <= buf->input_length) {
+        const uint8_t *p = &buf->input[buf->input_ptr];
+        uint64_t value = (uint64_t) p[0] | ((uint64_t) p[1] << 8) | ((uint64_t) p[2] << 16) |
+            ((uint64_t) p[3] << 24) | ((uint64_t) p[4] << 32) | ((uint64_t) p[5] << 40) |
+            ((uint64_t) p[6] << 48) | ((uint64_t) p[7] << 56);
+        buf->bits |= value << buf->bits_available;
+        buf->input_ptr += (63 - buf->bits_available) >> 3;
+        buf->bits_available |= 56;
+    } else {
+        // Near the end of the input: past the end, bits read as zero
+        while (buf->bits_available <= 56) {
+            uint64_t value = buf->input_ptr < buf->input_length ? buf->input[buf->input_ptr] : 0;
+            buf->input_ptr++;
+            buf->bits |= value << buf->bits_available;
+            buf->bits_available += 8;
         }
-        buf->input_buffer_ptr = 0;
     }
+}
 
-    buf->current_input_byte |= (uint16_t) (buf->input_buffer[buf->input_buffer_ptr++] << 8);
-    buf->current_input_byte = (uint16_t) (buf->current_input_byte >> (num_bits - buf->current_input_bits_available));
-    buf->current_input_bits_available += 8 - num_bits;
-    return 0;
+static inline void pk_explode_use_bits(struct pk_decomp_buffer *buf, int num_bits)
+{
+    buf->bits >>= num_bits;
+    buf->bits_available -= num_bits;
+    buf->bits_left -= num_bits;
 }
 
 static int pk_explode_decode_next_token(struct pk_decomp_buffer *buf)
 {
-    if (buf->current_input_byte & 1) {
-        // copy
-        if (pk_explode_set_bits_used(buf, 1)) {
-            return PK_ERROR_VALUE;
-        }
-        int index = buf->copy_length_jump_table[buf->current_input_byte & 0xff];
-        if (pk_explode_set_bits_used(buf, pk_copy_length_base_bits[index])) {
-            return PK_ERROR_VALUE;
-        }
-        int extra_bits = pk_copy_length_extra_bits[index];
-        if (extra_bits) {
-            int extra_bits_value = buf->current_input_byte & ((1 << extra_bits) - 1);
-            if (pk_explode_set_bits_used(buf, extra_bits) && index + extra_bits_value != 270) {
-                return PK_ERROR_VALUE;
-            }
-            index = pk_copy_length_base_value[index] + extra_bits_value;
-        }
-        return index + 256;
-    } else {
+    // A token takes at most 16 bits, followed by at most 14 bits for the copy offset
+    pk_explode_refill_bits(buf);
+    if (!(buf->bits & 1)) {
         // literal token
-        if (pk_explode_set_bits_used(buf, 1)) {
-            return PK_ERROR_VALUE;
-        }
-        int result = buf->current_input_byte & 0xff;
-        if (pk_explode_set_bits_used(buf, 8)) {
+        int result = (buf->bits >> 1) & 0xff;
+        pk_explode_use_bits(buf, 9);
+        return buf->bits_left >= 0 ? result : PK_ERROR_VALUE;
+    }
+    // copy
+    const struct pk_length_code *code = &buf->length_table[(buf->bits >> 1) & 0xff];
+    pk_explode_use_bits(buf, code->bits);
+    if (buf->bits_left < 0) {
+        return PK_ERROR_VALUE;
+    }
+    int index = code->base_value;
+    if (code->extra_bits) {
+        index += buf->bits & ((1 << code->extra_bits) - 1);
+        pk_explode_use_bits(buf, code->extra_bits);
+        // The end of stream marker may end the input
+        if (buf->bits_left < 0 && index + 256 != PK_EOF) {
             return PK_ERROR_VALUE;
         }
-        return result;
     }
+    return index + 256;
 }
 
 static int pk_explode_get_copy_offset(struct pk_decomp_buffer *buf, int copy_length)
 {
-    int index = buf->copy_offset_jump_table[buf->current_input_byte & 0xff];
-    if (pk_explode_set_bits_used(buf, pk_copy_offset_bits[index])) {
-        return 0;
-    }
+    const struct pk_offset_code *code = &buf->offset_table[buf->bits & 0xff];
+    pk_explode_use_bits(buf, code->bits);
     int offset;
     if (copy_length == 2) {
-        offset = (buf->current_input_byte & 3) | (index << 2);
-        if (pk_explode_set_bits_used(buf, 2)) {
-            return 0;
+        offset = (buf->bits & 3) | (code->index << 2);
+        pk_explode_use_bits(buf, 2);
+    } else {
+        offset = (buf->bits & buf->dictionary_size) | (code->index << buf->window_size);
+        pk_explode_use_bits(buf, buf->window_size);
+    }
+    return buf->bits_left >= 0 ? offset + 1 : 0;
+}
+
+static void pk_explode_copy(struct pk_decomp_buffer *buf, int offset, int length)
+{
+    uint8_t *dst = &buf->output[buf->output_ptr];
+    if (offset > buf->output_ptr) {
+        // The window starts out filled with zeros
+        for (int i = 0; i < length; i++) {
+            dst[i] = buf->output_ptr + i >= offset ? dst[i - offset] : 0;
+        }
+    } else if (offset >= 8) {
+        // Copy a word at a time: the source is always at least a word behind,
+        // so overlapping copies repeat the pattern correctly
+        const uint8_t *src = dst - offset;
+        int i = 0;
+        for (; i + 8 <= length; i += 8) {
+            memcpy(&dst[i], &src[i], 8);
         }
+        for (; i < length; i++) {
+            dst[i] = src[i];
+        }
+    } else if (offset == 1) {
+        memset(dst, dst[-1], length);
     } else {
-        offset = (buf->current_input_byte & buf->dictionary_size) | (index << buf->window_size);
-        if (pk_explode_set_bits_used(buf, buf->window_size)) {
-            return 0;
+        const uint8_t *src = dst - offset;
+        for (int i = 0; i < length; i++) {
+            dst[i] = src[i];
         }
     }
-    return offset + 1;
+    buf->output_ptr += length;
 }
 
 static int pk_explode_data(struct pk_decomp_buffer *buf)
 {
-    int token;
-    buf->output_buffer_ptr = 4096;
     while (1) {
-        token = pk_explode_decode_next_token(buf);
+        int token = pk_explode_decode_next_token(buf);
         if (token >= PK_ERROR_VALUE - 1) {
-            break;
+            return token;
         }
         if (token >= 256) {
             // copy offset
             int length = token - 254;
             int offset = pk_explode_get_copy_offset(buf, length);
             if (!offset) {
-                token = PK_ERROR_VALUE;
-                break;
+                return PK_ERROR_VALUE;
             }
-            uint8_t *src = &buf->output_buffer[buf->output_buffer_ptr - offset];
-            uint8_t *dst = &buf->output_buffer[buf->output_buffer_ptr];
-            buf->output_buffer_ptr += length;
-            do {
-                *dst = *src;
-                src++;
-                dst++;
-            } while (--length > 0);
+            if (buf->output_ptr + length > buf->output_length) {
+                log_error(buf->output_ptr >= buf->output_length ?
+                    "COMP2 Out of buffer space." : "COMP1 Corrupt.", 0, 0);
+                return PK_ERROR_VALUE;
+            }
+            pk_explode_copy(buf, offset, length);
         } else {
             // literal byte
-            buf->output_buffer[buf->output_buffer_ptr++] = (uint8_t) token;
-        }
-        if (buf->output_buffer_ptr >= 8192) {
-            // Flush buffer
-            buf->output_func(&buf->output_buffer[4096], 4096, buf->token);
-            pk_memcpy(buf->output_buffer, &buf->output_buffer[4096], buf->output_buffer_ptr - 4096);
-            buf->output_buffer_ptr -= 4096;
+            if (buf->output_ptr >= buf->output_length) {
+                log_error("COMP2 Out of buffer space.", 0, 0);
+                return PK_ERROR_VALUE;
+            }
+            buf->output[buf->output_ptr++] = (uint8_t) token;
         }
     }
-    int remaining_bytes = buf->output_buffer_ptr - 4096;
-    if (remaining_bytes > 0) {
-        // Flush buffer if needed
-        buf->output_func(&buf->output_buffer[4096], remaining_bytes, buf->token);
-    }
-    return token;
 }
 
-static int pk_explode(pk_input_func *input_func, pk_output_func *output_func,
-                      struct pk_decomp_buffer *buf, struct pk_token *token)
+static int pk_explode(struct pk_decomp_buffer *buf)
 {
-    buf->input_func = input_func;
-    buf->output_func = output_func;
-    buf->token = token;
-    buf->input_buffer_ptr = 2048;
-    int bytes_read = buf->input_func(buf->input_buffer, buf->input_buffer_ptr, buf->token);
-    buf->input_buffer_end = bytes_read;
-    if (bytes_read <= 4) {
+    if (buf->input_length <= 4) {
         return PK_TOO_FEW_INPUT_BYTES;
     }
-    int has_literal_encoding = buf->input_buffer[0];
-    buf->window_size = buf->input_buffer[1];
-    buf->current_input_byte = buf->input_buffer[2];
-    buf->current_input_bits_available = 0;
-    buf->input_buffer_ptr = 3;
+    int has_literal_encoding = buf->input[0];
+    buf->window_size = buf->input[1];
+    buf->input_ptr = 2;
+    buf->bits = 0;
+    buf->bits_available = 0;
+    buf->bits_left = 8 * (int64_t) (buf->input_length - 2) - 8;
 
     if (buf->window_size < 4 || buf->window_size > 6) {
         return PK_INVALID_WINDOWSIZE;
@@ -283,10 +273,8 @@ static int pk_explode(pk_input_func *input_func, pk_output_func *output_func,
     }
 
     // Decode data for copying bytes
-    pk_explode_construct_jump_table(16,
-        pk_copy_length_base_bits, pk_copy_length_base_code, buf->copy_length_jump_table);
-    pk_explode_construct_jump_table(64,
-        pk_copy_offset_bits, pk_copy_offset_code, buf->copy_offset_jump_table);
+    pk_explode_construct_length_table(buf->length_table);
+    pk_explode_construct_offset_table(buf->offset_table);
 
     int result = pk_explode_data(buf);
     if (result != PK_EOF) {
@@ -295,61 +283,21 @@ static int pk_explode(pk_input_func *input_func, pk_output_func *output_func,
     return PK_SUCCESS;
 }
 
-static int zip_input_func(uint8_t *buffer, int length, struct pk_token *token)
-{
-    if (token->stop) {
-        return 0;
-    }
-    if (token->input_ptr >= token->input_length) {
-        return 0;
-    }
-
-    if (token->input_length - token->input_ptr < length) {
-        length = token->input_length - token->input_ptr;
-    }
-    memcpy(buffer, &token->input_data[token->input_ptr], (size_t) length);
-    token->input_ptr += length;
-    return length;
-}
-
-static void zip_output_func(uint8_t *buffer, int length, struct pk_token *token)
-{
-    if (token->stop) {
-        return;
-    }
-    if (token->output_ptr >= token->output_length) {
-        log_error("COMP2 Out of buffer space.", 0, 0);
-        token->stop = 1;
-        return;
-    }
-
-    if (token->output_length - token->output_ptr >= length) {
-        memcpy(&token->output_data[token->output_ptr], buffer, (size_t) length);
-        token->output_ptr += length;
-    } else {
-        log_error("COMP1 Corrupt.", 0, 0);
-        token->stop = 1;
-    }
-}
-
 int zip_decompress(const void *input_buffer, int input_length,
                    void *output_buffer, int output_length)
 {
-    struct pk_token token;
     struct pk_decomp_buffer *buf = (struct pk_decomp_buffer *) malloc(sizeof(struct pk_decomp_buffer));
     if (!buf) {
         return 0;
     }
     memset(buf, 0, sizeof(struct pk_decomp_buffer));
-    memset(&token, 0, sizeof(struct pk_token));
-    token.input_data = (const uint8_t *) input_buffer;
-    token.input_length = input_length;
-    token.output_data = (uint8_t *) output_buffer;
-    token.output_length = output_length;
+    buf->input = (const uint8_t *) input_buffer;
+    buf->input_length = input_length;
+    buf->output = (uint8_t *) output_buffer;
+    buf->output_length = output_length;
 
     int ok = 1;
-    int pk_error = pk_explode(zip_input_func, zip_output_func, buf, &token);
-    if (pk_error || token.stop) {
+    if (pk_explode(buf)) {
         log_error("COMP Error uncompressing.", 0, 0);
         ok = 0;
     }
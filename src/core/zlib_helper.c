@@ -51,3 +51,13 @@ int zlib_helper_compress(void *input_buffer, const int input_length, void *outpu
     *output_length = output_buffer_length - strm.avail_out;
     return 1;
 }
+
+unsigned int zlib_helper_adler32(const void *buffer, const int length)
+{
+    return (unsigned int) mz_adler32(MZ_ADLER32_INIT, buffer, length);
+}
+
+int zlib_helper_compress_bound(const int input_length)
+{
+    return (int) mz_compressBound(input_length);
+}
@@ -5,4 +5,8 @@ int zlib_helper_decompress(void *input_buffer, const int input_length, void *out
 
 int zlib_helper_compress(void *input_buffer, const int input_length, void *output_buffer, const int output_buffer_length, int *output_length);
 
+int zlib_helper_compress_bound(const int input_length);
+
+unsigned int zlib_helper_adler32(const void *buffer, const int length);
+
 #endif // CORE_ZLIB_HELPER_H
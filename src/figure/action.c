@@ -22,6 +22,9 @@
 #include "figuretype/wall.h"
 #include "figuretype/water.h"
 #include "figuretype/workcamp.h"
+#include "game/profiler.h"
+
+#include <string.h>
 
 
 static void figure_nobody_action(figure *f)
@@ -127,10 +130,37 @@ static void (*figure_action_callbacks[])(figure *f) = {
     figure_catapult_missile_action,
 };
 
+static struct {
+    time_micros micros[FIGURE_TYPE_MAX];
+    int figures[FIGURE_TYPE_MAX];
+} type_profile;
+
+static void run_profiled_action(figure *f)
+{
+    int type = f->type;
+    time_micros start = time_get_micros();
+    figure_action_callbacks[type](f);
+    type_profile.micros[type] += time_get_micros() - start;
+    type_profile.figures[type]++;
+}
+
+static void record_type_profile(void)
+{
+    for (int type = 0; type < FIGURE_TYPE_MAX; type++) {
+        if (type_profile.figures[type]) {
+            game_profiler_record_figure_type(type, type_profile.micros[type]);
+        }
+    }
+}
+
 void figure_action_handle(void)
 {
     city_figures_reset();
     city_entertainment_set_hippodrome_has_race(0);
+    int is_profiling = game_profiler_is_enabled();
+    if (is_profiling) {
+        memset(&type_profile, 0, sizeof(type_profile));
+    }
     for (int i = 1; i < figure_count(); i++) {
         figure *f = figure_get(i);
         if (f->state) {
@@ -143,10 +173,17 @@ void figure_action_handle(void)
                     f->targeted_by_figure_id = 0;
                 }
             }
-            figure_action_callbacks[f->type](f);
+            if (is_profiling) {
+                run_profiled_action(f);
+            } else {
+                figure_action_callbacks[f->type](f);
+            }
             if (f->state == FIGURE_STATE_DEAD) {
                 figure_delete(f);
             }
         }
     }
+    if (is_profiling) {
+        record_type_profile();
+    }
 }
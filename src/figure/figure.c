@@ -204,6 +204,7 @@ void figure_delete(figure *f)
     memset(f, 0, sizeof(figure));
     f->id = figure_id;
 
+    array_release_item(data.figures, figure_id);
     array_trim(data.figures);
 }
 
@@ -240,6 +241,7 @@ static int figure_is_active(const figure *f)
 void figure_init_scenario(void)
 {
     if (!array_init(data.figures, FIGURE_ARRAY_SIZE_STEP, initialize_new_figure, figure_is_active) ||
+        !array_enable_free_slots(data.figures) ||
         !array_next(data.figures)) { // Ignore first figure
         log_error("Unable to create figures array. The game will now crash.", 0, 0);
     }
@@ -542,6 +544,7 @@ void figure_load_state(buffer *list, buffer *seq, int version)
     int figures_to_load = (int) buf_size / figure_buf_size;
 
     if (!array_init(data.figures, FIGURE_ARRAY_SIZE_STEP, initialize_new_figure, figure_is_active) ||
+        !array_enable_free_slots(data.figures) ||
         !array_expand(data.figures, figures_to_load)) {
         log_error("Unable to create figures array. The game will now crash.", 0, 0);
     }
@@ -19,6 +19,9 @@ typedef struct {
     unsigned char alternative_location_index;
     unsigned char flotsam_visible;
     short next_figure_id_on_same_tile;
+    unsigned short bucket_id; // 0 when not in a map bucket, otherwise bucket + 1
+    unsigned short next_figure_id_in_bucket;
+    unsigned short previous_figure_id_in_bucket;
     unsigned char type;
     unsigned char resource_id;
     unsigned char use_cross_country;
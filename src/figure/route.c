@@ -5,17 +5,43 @@
 #include "map/routing.h"
 #include "map/routing_path.h"
 
+#include <string.h>
+
 #define ARRAY_SIZE_STEP 600
 #define MAX_PATH_LENGTH 500
 
+#define ROUTE_CACHE_SIZE 1024
+#define ROUTE_CACHE_BUCKETS 2048
+#define NOT_CACHEABLE -1
+
 typedef struct {
     unsigned int id;
     int figure_id;
     uint8_t directions[MAX_PATH_LENGTH];
 } figure_path_data;
 
+typedef struct {
+    int src_offset;
+    int dst_offset;
+    int terrain_usage;
+    int direction_limit;
+    int path_length;
+    unsigned int last_used;
+    int next_in_bucket; // index + 1, 0 = end of chain
+    map_routing_search_area area;
+    uint8_t directions[MAX_PATH_LENGTH];
+} cached_route;
+
 static array(figure_path_data) paths;
 
+static struct {
+    cached_route routes[ROUTE_CACHE_SIZE];
+    int buckets[ROUTE_CACHE_BUCKETS]; // index + 1, 0 = empty
+    unsigned int use_counter;
+    int hits;
+    int misses;
+} cache;
+
 static void create_new_path(figure_path_data *path, unsigned int position)
 {
     path->id = position;
@@ -26,8 +52,111 @@ static int path_is_used(const figure_path_data *path)
     return path->figure_id != 0;
 }
 
+static void route_cache_clear(void)
+{
+    for (int i = 0; i < ROUTE_CACHE_SIZE; i++) {
+        cache.routes[i].path_length = 0;
+    }
+    memset(cache.buckets, 0, sizeof(cache.buckets));
+}
+
+static int route_cache_terrain_usage(const figure *f)
+{
+    // only road searches are cached: they depend on nothing but the routing terrain
+    switch (f->terrain_usage) {
+        case TERRAIN_USAGE_ROADS:
+        case TERRAIN_USAGE_PREFER_ROADS:
+            return TERRAIN_USAGE_ROADS;
+        case TERRAIN_USAGE_ROADS_HIGHWAY:
+        case TERRAIN_USAGE_PREFER_ROADS_HIGHWAY:
+            return TERRAIN_USAGE_ROADS_HIGHWAY;
+        default:
+            return NOT_CACHEABLE;
+    }
+}
+
+static int route_cache_bucket(int src_offset, int dst_offset, int terrain_usage, int direction_limit)
+{
+    unsigned int hash = (unsigned int) src_offset * 2654435761u;
+    hash ^= (unsigned int) dst_offset * 40503u + terrain_usage * 8 + direction_limit;
+    return (hash ^ (hash >> 16)) % ROUTE_CACHE_BUCKETS;
+}
+
+static void route_cache_remove(int index)
+{
+    cached_route *route = &cache.routes[index];
+    int *link = &cache.buckets[route_cache_bucket(route->src_offset, route->dst_offset,
+        route->terrain_usage, route->direction_limit)];
+    while (*link && *link != index + 1) {
+        link = &cache.routes[*link - 1].next_in_bucket;
+    }
+    if (*link) {
+        *link = route->next_in_bucket;
+    }
+    route->path_length = 0;
+}
+
+static int route_cache_get(const figure *f, int direction_limit, uint8_t *directions)
+{
+    int terrain_usage = route_cache_terrain_usage(f);
+    if (terrain_usage == NOT_CACHEABLE) {
+        return 0;
+    }
+    int src_offset = map_grid_offset(f->x, f->y);
+    int dst_offset = map_grid_offset(f->destination_x, f->destination_y);
+    int index = cache.buckets[route_cache_bucket(src_offset, dst_offset, terrain_usage, direction_limit)];
+    while (index) {
+        cached_route *route = &cache.routes[index - 1];
+        if (route->src_offset == src_offset && route->dst_offset == dst_offset &&
+            route->terrain_usage == terrain_usage && route->direction_limit == direction_limit) {
+            if (map_routing_search_area_changed(&route->area)) {
+                route_cache_remove(index - 1);
+                break;
+            }
+            route->last_used = ++cache.use_counter;
+            memcpy(directions, route->directions, route->path_length);
+            cache.hits++;
+            return route->path_length;
+        }
+        index = route->next_in_bucket;
+    }
+    cache.misses++;
+    return 0;
+}
+
+static void route_cache_add(const figure *f, int direction_limit, const uint8_t *directions, int path_length)
+{
+    int index = 0;
+    for (int i = 0; i < ROUTE_CACHE_SIZE; i++) {
+        if (!cache.routes[i].path_length) {
+            index = i;
+            break;
+        }
+        if (cache.routes[i].last_used < cache.routes[index].last_used) {
+            index = i;
+        }
+    }
+    if (cache.routes[index].path_length) {
+        route_cache_remove(index);
+    }
+    cached_route *route = &cache.routes[index];
+    route->src_offset = map_grid_offset(f->x, f->y);
+    route->dst_offset = map_grid_offset(f->destination_x, f->destination_y);
+    route->terrain_usage = route_cache_terrain_usage(f);
+    route->direction_limit = direction_limit;
+    route->path_length = path_length;
+    route->last_used = ++cache.use_counter;
+    map_routing_get_search_area(&route->area);
+    memcpy(route->directions, directions, path_length);
+    int *bucket = &cache.buckets[route_cache_bucket(route->src_offset, route->dst_offset,
+        route->terrain_usage, route->direction_limit)];
+    route->next_in_bucket = *bucket;
+    *bucket = index + 1;
+}
+
 void figure_route_clear_all(void)
 {
+    route_cache_clear();
     paths.size = 0;
     array_trim(paths);
 }
@@ -41,6 +170,7 @@ void figure_route_clean(void)
             const figure *f = figure_get(figure_id);
             if (f->state != FIGURE_STATE_ALIVE || f->routing_path_id != array_index) {
                 path->figure_id = 0;
+                array_release_item(paths, array_index);
             }
         }
     }
@@ -56,7 +186,8 @@ void figure_route_add(figure *f)
     if (f->disallow_diagonal) {
         direction_limit = 4;
     }
-    if (!paths.blocks && !array_init(paths, ARRAY_SIZE_STEP, create_new_path, path_is_used)) {
+    if (!paths.blocks && (!array_init(paths, ARRAY_SIZE_STEP, create_new_path, path_is_used) ||
+        !array_enable_free_slots(paths))) {
         log_error("Unable to create paths array. The game will likely crash.", 0, 0);
         return;
     }
@@ -76,9 +207,12 @@ void figure_route_add(figure *f)
             path_length = map_routing_get_path_on_water(path->directions,
                 f->destination_x, f->destination_y, 0);
         }
+    } else if ((path_length = route_cache_get(f, direction_limit, path->directions)) > 0) {
+        map_routing_count_cached_route();
     } else {
         // land figure
         int can_travel;
+        int is_cacheable = 0;
         switch (f->terrain_usage) {
             case TERRAIN_USAGE_ENEMY:
                 // check to see if we can reach our destination by going around the city walls
@@ -104,6 +238,7 @@ void figure_route_add(figure *f)
             case TERRAIN_USAGE_PREFER_ROADS:
                 can_travel = map_routing_citizen_can_travel_over_road_garden(f->x, f->y,
                     f->destination_x, f->destination_y, direction_limit);
+                is_cacheable = can_travel;
                 if (!can_travel) {
                     can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
                         f->destination_x, f->destination_y, direction_limit);
@@ -112,10 +247,12 @@ void figure_route_add(figure *f)
             case TERRAIN_USAGE_ROADS:
                 can_travel = map_routing_citizen_can_travel_over_road_garden(f->x, f->y,
                     f->destination_x, f->destination_y, direction_limit);
+                is_cacheable = can_travel;
                 break;
             case TERRAIN_USAGE_PREFER_ROADS_HIGHWAY:
                 can_travel = map_routing_citizen_can_travel_over_road_garden_highway(f->x, f->y,
                     f->destination_x, f->destination_y, direction_limit);
+                is_cacheable = can_travel;
                 if (!can_travel) {
                     can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
                         f->destination_x, f->destination_y, direction_limit);
@@ -124,6 +261,7 @@ void figure_route_add(figure *f)
             case TERRAIN_USAGE_ROADS_HIGHWAY:
                 can_travel = map_routing_citizen_can_travel_over_road_garden_highway(f->x, f->y,
                     f->destination_x, f->destination_y, direction_limit);
+                is_cacheable = can_travel;
                 break;
             default:
                 can_travel = map_routing_citizen_can_travel_over_land(f->x, f->y,
@@ -144,6 +282,9 @@ void figure_route_add(figure *f)
         } else { // cannot travel
             path_length = 0;
         }
+        if (is_cacheable && path_length > 0) {
+            route_cache_add(f, direction_limit, path->directions, path_length);
+        }
     }
     if (path_length) {
         path->figure_id = f->id;
@@ -157,6 +298,7 @@ void figure_route_remove(figure *f)
     if (f->routing_path_id > 0) {
         if (f->routing_path_id < paths.size && array_item(paths, f->routing_path_id)->figure_id == f->id) {
             array_item(paths, f->routing_path_id)->figure_id = 0;
+            array_release_item(paths, f->routing_path_id);
         }
         f->routing_path_id = 0;
     }
@@ -187,9 +329,12 @@ void figure_route_save_state(buffer *figures, buffer *buf_paths)
 
 void figure_route_load_state(buffer *figures, buffer *buf_paths)
 {
+    route_cache_clear();
+
     int elements_to_load = (int) buf_paths->size / MAX_PATH_LENGTH;
 
     if (!array_init(paths, ARRAY_SIZE_STEP, create_new_path, path_is_used) ||
+        !array_enable_free_slots(paths) ||
         !array_expand(paths, elements_to_load)) {
         log_error("Unable to create paths array. The game will likely crash.", 0, 0);
         return;
@@ -207,3 +352,9 @@ void figure_route_load_state(buffer *figures, buffer *buf_paths)
     }
     paths.size = highest_id_in_use + 1;
 }
+
+void figure_route_get_cache_stats(int *hits, int *misses)
+{
+    *hits = cache.hits;
+    *misses = cache.misses;
+}
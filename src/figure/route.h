@@ -18,4 +18,6 @@ void figure_route_save_state(buffer *figures, buffer *buf_paths);
 
 void figure_route_load_state(buffer *figures, buffer *buf_paths);
 
+void figure_route_get_cache_stats(int *hits, int *misses);
+
 #endif // FIGURE_ROUTE_H
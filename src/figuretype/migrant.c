@@ -172,7 +172,7 @@ void figure_immigrant_action(figure *f)
                 }
                 int is_empty = b->house_population == 0;
                 b->house_population += f->migrant_num_people;
-                b->house_population_room = max_people - b->house_population;
+                house_population_set_room(b, max_people - b->house_population);
                 city_population_add(f->migrant_num_people);
                 if (is_empty) {
                     building_house_change_to(b, BUILDING_HOUSE_SMALL_TENT);
@@ -320,7 +320,7 @@ void figure_homeless_action(figure *f)
                     }
                     int is_empty = b->house_population == 0;
                     b->house_population += f->migrant_num_people;
-                    b->house_population_room = max_people - b->house_population;
+                    house_population_set_room(b, max_people - b->house_population);
                     city_population_add_homeless(f->migrant_num_people);
                     if (is_empty) {
                         building_house_change_to(b, BUILDING_HOUSE_SMALL_TENT);
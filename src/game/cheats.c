@@ -14,7 +14,9 @@
 #include "core/string.h"
 #include "empire/city.h"
 #include "figure/figure.h"
+#include "figure/route.h"
 #include "figuretype/crime.h"
+#include "game/profiler.h"
 #include "game/tick.h"
 #include "graphics/color.h"
 #include "graphics/font.h"
@@ -50,6 +52,9 @@ static void game_cheat_show_editor(uint8_t *);
 static void game_cheat_cast_curse(uint8_t *);
 static void game_cheat_make_buildings_invincible(uint8_t *);
 static void game_cheat_change_climate(uint8_t *);
+static void game_cheat_show_route_cache(uint8_t *);
+static void game_cheat_toggle_profiler(uint8_t *);
+static void game_cheat_dump_profiler(uint8_t *);
 
 static void (*const execute_command[])(uint8_t *args) = {
     game_cheat_add_money,
@@ -66,7 +71,10 @@ static void (*const execute_command[])(uint8_t *args) = {
     game_cheat_show_editor,
     game_cheat_cast_curse,
     game_cheat_make_buildings_invincible,
-    game_cheat_change_climate
+    game_cheat_change_climate,
+    game_cheat_show_route_cache,
+    game_cheat_toggle_profiler,
+    game_cheat_dump_profiler
 };
 
 static const char *commands[] = {
@@ -84,7 +92,10 @@ static const char *commands[] = {
     "debug.showeditor",
     "curse",
     "romanconcrete",
-    "globalwarming"
+    "globalwarming",
+    "debug.routecache",
+    "debug.profiler",
+    "debug.profilerdump"
 };
 
 #define NUMBER_OF_COMMANDS sizeof (commands) / sizeof (commands[0])
@@ -291,6 +302,41 @@ static void game_cheat_show_editor(uint8_t *args)
     }
 }
 
+static void game_cheat_show_route_cache(uint8_t *args)
+{
+    int hits, misses;
+    figure_route_get_cache_stats(&hits, &misses);
+    uint8_t hits_text[12];
+    uint8_t misses_text[12];
+    string_from_int(hits_text, hits, 0);
+    string_from_int(misses_text, misses, 0);
+    const uint8_t *parts[] = {
+        lang_get_string(CUSTOM_TRANSLATION, TR_CHEAT_ROUTE_CACHE_HITS), string_from_ascii(": "), hits_text,
+        string_from_ascii(", "), lang_get_string(CUSTOM_TRANSLATION, TR_CHEAT_ROUTE_CACHE_MISSES),
+        string_from_ascii(": "), misses_text
+    };
+    uint8_t text[MAX_COMMAND_SIZE * 2];
+    uint8_t *cursor = text;
+    for (int i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+        cursor = string_copy(parts[i], cursor, (int) (sizeof(text) - (cursor - text)));
+    }
+    city_warning_show_custom(text, NEW_WARNING_SLOT);
+}
+
+static void game_cheat_toggle_profiler(uint8_t *args)
+{
+    int enabled = 0;
+    parse_integer(args, &enabled);
+    game_profiler_enable(enabled);
+    show_warning(enabled ? TR_CHEAT_PROFILER_ENABLED : TR_CHEAT_PROFILER_DISABLED);
+}
+
+static void game_cheat_dump_profiler(uint8_t *args)
+{
+    game_profiler_dump();
+    show_warning(TR_CHEAT_PROFILER_DUMPED);
+}
+
 void game_cheat_parse_command(uint8_t *command)
 {
     uint8_t command_to_call[MAX_COMMAND_SIZE];
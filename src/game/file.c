@@ -37,6 +37,7 @@
 #include "game/file_io.h"
 #include "game/settings.h"
 #include "game/state.h"
+#include "game/tick.h"
 #include "game/time.h"
 #include "game/tutorial.h"
 #include "game/undo.h"
@@ -116,6 +117,7 @@ static void clear_scenario_data(void)
     figure_visited_buildings_init();
     scenario_events_clear();
     custom_messages_clear_all();
+    game_tick_clear_pending_map_updates();
 
     game_time_init(2098);
 
@@ -449,9 +451,16 @@ int game_file_load_saved_game(const char *filename)
 
 int game_file_write_saved_game(const char *filename)
 {
+    game_tick_finish_pending_map_updates();
     return game_file_io_write_saved_game(filename);
 }
 
+int game_file_write_saved_game_in_background(const char *filename)
+{
+    game_tick_finish_pending_map_updates();
+    return game_file_io_write_saved_game_in_background(filename);
+}
+
 int game_file_delete_saved_game(const char *filename)
 {
     return game_file_io_delete_saved_game(filename);
@@ -41,6 +41,13 @@ int game_file_load_saved_game(const char *filename);
  */
 int game_file_write_saved_game(const char *filename);
 
+/**
+ * Write saved game to disk on a background thread, see game_file_io_is_saving
+ * @param filename File to save to
+ * @return Boolean true if the save was started, false on failure
+ */
+int game_file_write_saved_game_in_background(const char *filename);
+
 /**
  * Delete saved game
  * @param filename File to delete
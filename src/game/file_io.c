@@ -10,6 +10,7 @@
 #include "city/data.h"
 #include "city/message.h"
 #include "city/view.h"
+#include "core/calc.h"
 #include "core/dir.h"
 #include "core/file.h"
 #include "core/log.h"
@@ -31,6 +32,7 @@
 #include "figure/visited_buildings.h"
 #include "game/file.h"
 #include "game/save_version.h"
+#include "game/system.h"
 #include "game/time.h"
 #include "game/tutorial.h"
 #include "map/aqueduct.h"
@@ -66,6 +68,7 @@
 #include "sound/city.h"
 #include "widget/minimap.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -73,6 +76,11 @@
 #define COMPRESS_BUFFER_INITIAL_SIZE 1000000
 #define UNCOMPRESSED 0x80000000
 #define PIECE_SIZE_DYNAMIC 0
+#define PIECE_INDEX_VERSION 1
+#define PIECE_INDEX_HEADER_SIZE 8
+#define PIECE_INDEX_ENTRY_SIZE 12
+#define MAX_SAVEGAME_PIECES (sizeof(savegame_state) / sizeof(buffer *) + 1)
+#define MAX_PIECE_WORKERS 8
 
 typedef struct {
     buffer buf;
@@ -80,6 +88,13 @@ typedef struct {
     int dynamic;
 } file_piece;
 
+typedef struct {
+    file_piece *piece;
+    size_t data_offset;
+    int data_size;
+    int result;
+} piece_task;
+
 typedef struct {
     buffer *resource_version;
     buffer *graphic_ids;
@@ -120,6 +135,7 @@ typedef struct {
     buffer *resource_version;
     buffer *scenario_campaign_mission;
     buffer *file_version;
+    buffer *piece_index;
     buffer *scenario_version;
     buffer *image_grid;
     buffer *edge_grid;
@@ -274,15 +290,36 @@ typedef struct {
         int visited_buildings;
         int custom_campaigns;
         int dynamic_scenario_objects;
+        int piece_index;
     } features;
 } savegame_version_data;
 
+typedef struct {
+    piece_task *tasks[MAX_SAVEGAME_PIECES];
+    int num_tasks;
+    size_t total_size;
+    uint8_t *data;
+    int (*process)(piece_task *task, uint8_t *data);
+} piece_worker;
+
 static struct {
     int num_pieces;
-    file_piece pieces[sizeof(savegame_state) / sizeof(buffer *) + 1];
+    int piece_index;
+    file_piece pieces[MAX_SAVEGAME_PIECES];
     savegame_state state;
 } savegame_data;
 
+static struct {
+    system_thread *thread;
+    FILE *fp;
+    char filename[FILE_NAME_MAX];
+    char temp_filename[FILE_NAME_MAX];
+    int num_pieces;
+    int piece_index;
+    file_piece pieces[MAX_SAVEGAME_PIECES];
+    memory_block compress_buffer;
+} pending_save;
+
 static struct {
     minimap_functions functions;
     savegame_version_t version;
@@ -498,6 +535,7 @@ static void get_version_data(savegame_version_data *version_data, savegame_versi
     version_data->features.visited_buildings = version > SAVE_GAME_LAST_GLOBAL_BUILDING_INFO;
     version_data->features.custom_campaigns = version > SAVE_GAME_LAST_NO_CUSTOM_CAMPAIGNS;
     version_data->features.dynamic_scenario_objects = version > SAVE_GAME_LAST_STATIC_SCENARIO_ORIGINAL_DATA;
+    version_data->features.piece_index = version > SAVE_GAME_LAST_NO_PIECE_INDEX;
 }
 
 static void init_savegame_data(savegame_version_t version)
@@ -513,6 +551,12 @@ static void init_savegame_data(savegame_version_t version)
     if (version_data.features.resource_version) {
         state->resource_version = create_savegame_piece(4, 0);
     }
+    savegame_data.piece_index = 0;
+    if (version_data.features.piece_index) {
+        // Filled in while writing the file, see savegame_write_to_file
+        savegame_data.piece_index = savegame_data.num_pieces;
+        state->piece_index = create_savegame_piece(PIECE_SIZE_DYNAMIC, 0);
+    }
     if (version_data.features.scenario_version) {
         state->scenario_version = create_savegame_piece(4, 0);
     }
@@ -1397,25 +1441,155 @@ static int savegame_read_from_buffer(buffer *buf, savegame_version_t version)
     return 1;
 }
 
-static int savegame_read_from_file(FILE *fp, savegame_version_t version)
+static int read_savegame_piece(FILE *fp, file_piece *piece, savegame_version_t version,
+    memory_block *compress_buffer)
 {
-    memory_block compress_buffer;
-    core_memory_block_init(&compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE);
-    for (int i = 0; i < savegame_data.num_pieces; i++) {
+    if (!prepare_dynamic_piece_from_file(fp, piece)) {
+        return 1;
+    }
+    if (piece->compressed) {
+        return read_compressed_savegame_chunk(fp, piece->buf.data, piece->buf.size, version, compress_buffer);
+    } else {
+        return fread(piece->buf.data, 1, piece->buf.size, fp) == piece->buf.size;
+    }
+}
+
+static int run_piece_worker(void *data)
+{
+    piece_worker *worker = data;
+    for (int i = 0; i < worker->num_tasks; i++) {
+        piece_task *task = worker->tasks[i];
+        task->result = worker->process(task, worker->data + task->data_offset);
+    }
+    return 1;
+}
+
+static void run_piece_tasks(piece_task *tasks, int num_tasks, uint8_t *data,
+    int (*process)(piece_task *task, uint8_t *data))
+{
+    piece_worker workers[MAX_PIECE_WORKERS];
+    system_thread *threads[MAX_PIECE_WORKERS];
+    int num_workers = calc_bound(system_get_cpu_count(), 1, MAX_PIECE_WORKERS);
+    if (num_workers > num_tasks) {
+        num_workers = num_tasks;
+    }
+    for (int w = 0; w < num_workers; w++) {
+        workers[w].num_tasks = 0;
+        workers[w].total_size = 0;
+        workers[w].data = data;
+        workers[w].process = process;
+    }
+    // Largest pieces first, each going to the worker with the least work so far
+    piece_task *sorted[MAX_SAVEGAME_PIECES];
+    for (int i = 0; i < num_tasks; i++) {
+        int j = i;
+        while (j > 0 && sorted[j - 1]->piece->buf.size < tasks[i].piece->buf.size) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = &tasks[i];
+    }
+    for (int i = 0; i < num_tasks; i++) {
+        piece_worker *least_busy = &workers[0];
+        for (int w = 1; w < num_workers; w++) {
+            if (workers[w].total_size < least_busy->total_size) {
+                least_busy = &workers[w];
+            }
+        }
+        least_busy->tasks[least_busy->num_tasks++] = sorted[i];
+        least_busy->total_size += sorted[i]->piece->buf.size;
+    }
+    for (int w = 1; w < num_workers; w++) {
+        threads[w] = system_thread_start(run_piece_worker, &workers[w]);
+    }
+    if (num_workers) {
+        run_piece_worker(&workers[0]);
+    }
+    for (int w = 1; w < num_workers; w++) {
+        if (threads[w]) {
+            system_thread_wait(threads[w]);
+        } else {
+            run_piece_worker(&workers[w]);
+        }
+    }
+}
+
+static int decompress_piece(piece_task *task, uint8_t *data)
+{
+    int output_size = 0;
+    return zlib_helper_decompress(data, task->data_size, task->piece->buf.data, (int) task->piece->buf.size,
+        &output_size);
+}
+
+static int compress_piece(piece_task *task, uint8_t *data)
+{
+    return zlib_helper_compress(task->piece->buf.data, (int) task->piece->buf.size, data, task->data_size,
+        &task->data_size);
+}
+
+static int savegame_read_from_file_in_parallel(FILE *fp)
+{
+    piece_task tasks[MAX_SAVEGAME_PIECES];
+    int num_tasks = 0;
+    memory_block compressed;
+    core_memory_block_init(&compressed, COMPRESS_BUFFER_INITIAL_SIZE);
+    size_t used = 0;
+    int result = 1;
+    // Read the compressed pieces into memory, then inflate them all at once
+    for (int i = 0; i < savegame_data.num_pieces && result; i++) {
         file_piece *piece = &savegame_data.pieces[i];
-        int result = 0;
         if (!prepare_dynamic_piece_from_file(fp, piece)) {
             continue;
         }
-        if (piece->compressed) {
-            result = read_compressed_savegame_chunk(fp, piece->buf.data, piece->buf.size, version, &compress_buffer);
-        } else {
+        int input_size = piece->compressed ? read_int32(fp) : 0;
+        if (!piece->compressed || (unsigned int) input_size == UNCOMPRESSED) {
             result = fread(piece->buf.data, 1, piece->buf.size, fp) == piece->buf.size;
+        } else if (input_size >= 0 && (size_t) input_size <= SIZE_MAX - used &&
+            core_memory_block_ensure_size(&compressed, used + input_size) &&
+            fread((uint8_t *) compressed.memory + used, 1, input_size, fp) == input_size) {
+            piece_task *task = &tasks[num_tasks++];
+            task->piece = piece;
+            task->data_offset = used;
+            task->data_size = input_size;
+            used += input_size;
+        } else {
+            result = 0;
         }
         // The last piece may be smaller than buf.size
+        if (!result && i == savegame_data.num_pieces - 1) {
+            result = 1;
+        }
+        if (!result) {
+            log_info("Incorrect buffer size, expected", 0, (int) piece->buf.size);
+        }
+    }
+    if (result) {
+        run_piece_tasks(tasks, num_tasks, compressed.memory, decompress_piece);
+        for (int i = 0; i < num_tasks; i++) {
+            if (!tasks[i].result && tasks[i].piece != &savegame_data.pieces[savegame_data.num_pieces - 1]) {
+                log_info("Unable to decompress piece, expected size", 0, (int) tasks[i].piece->buf.size);
+                result = 0;
+            }
+        }
+    }
+    core_memory_block_free(&compressed);
+    return result;
+}
+
+static int savegame_read_from_file(FILE *fp, savegame_version_t version)
+{
+    if (version > SAVE_GAME_LAST_ZIP_COMPRESSION) {
+        return savegame_read_from_file_in_parallel(fp);
+    }
+    // Legacy PKWARE compressed pieces are read one at a time
+    memory_block compress_buffer;
+    core_memory_block_init(&compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE);
+    for (int i = 0; i < savegame_data.num_pieces; i++) {
+        int result = read_savegame_piece(fp, &savegame_data.pieces[i], version, &compress_buffer);
+        // The last piece may be smaller than buf.size
         if (!result && i != (savegame_data.num_pieces - 1)) {
             log_info("Incorrect buffer size, got", 0, result);
-            log_info("Incorrect buffer size, expected", 0, (int) piece->buf.size);
+            log_info("Incorrect buffer size, expected", 0, (int) savegame_data.pieces[i].buf.size);
             core_memory_block_free(&compress_buffer);
             return 0;
         }
@@ -1424,21 +1598,124 @@ static int savegame_read_from_file(FILE *fp, savegame_version_t version)
     return 1;
 }
 
-static void savegame_write_to_file(FILE *fp, memory_block *compress_buffer)
+static int is_file_info_piece(const savegame_state *state, const buffer *buf)
 {
-    for (int i = 0; i < savegame_data.num_pieces; i++) {
+    return buf == state->scenario_version || buf == state->edge_grid || buf == state->building_grid ||
+        buf == state->terrain_grid || buf == state->bitfields_grid || buf == state->random_grid ||
+        buf == state->city_data || buf == state->buildings || buf == state->game_time || buf == state->scenario ||
+        buf == state->invasions || buf == state->scenario_is_custom || buf == state->scenario_name ||
+        buf == state->campaign_name;
+}
+
+static int savegame_read_file_info_pieces_from_file(FILE *fp, savegame_version_t version)
+{
+    if (!savegame_data.piece_index) {
+        return 0;
+    }
+    long start = ftell(fp);
+    memory_block compress_buffer;
+    core_memory_block_init(&compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE);
+    int result = 1;
+    for (int i = 0; i <= savegame_data.piece_index && result; i++) {
+        result = read_savegame_piece(fp, &savegame_data.pieces[i], version, &compress_buffer);
+    }
+    buffer *index = savegame_data.state.piece_index;
+    if (!result || index->size != PIECE_INDEX_HEADER_SIZE + savegame_data.num_pieces * PIECE_INDEX_ENTRY_SIZE ||
+        buffer_read_i32(index) != PIECE_INDEX_VERSION || buffer_read_i32(index) != savegame_data.num_pieces) {
+        core_memory_block_free(&compress_buffer);
+        return 0;
+    }
+    buffer_skip(index, (savegame_data.piece_index + 1) * PIECE_INDEX_ENTRY_SIZE);
+    for (int i = savegame_data.piece_index + 1; i < savegame_data.num_pieces && result; i++) {
         file_piece *piece = &savegame_data.pieces[i];
-        if (piece->dynamic) {
-            write_int32(fp, (int) piece->buf.size);
-            if (!piece->buf.size) {
-                continue;
-            }
+        long offset = start + buffer_read_u32(index);
+        long length = buffer_read_u32(index);
+        uint32_t checksum = buffer_read_u32(index);
+        if (!is_file_info_piece(&savegame_data.state, &piece->buf)) {
+            continue;
         }
-        if (piece->compressed) {
-            write_compressed_chunk(fp, piece->buf.data, piece->buf.size, compress_buffer);
+        result = fseek(fp, offset, SEEK_SET) == 0 &&
+            read_savegame_piece(fp, piece, version, &compress_buffer) &&
+            ftell(fp) - offset == length &&
+            (!piece->buf.size || zlib_helper_adler32(piece->buf.data, (int) piece->buf.size) == checksum);
+    }
+    core_memory_block_free(&compress_buffer);
+    return result;
+}
+
+static void savegame_write_to_file(FILE *fp, file_piece *pieces, int num_pieces, int piece_index,
+    memory_block *compress_buffer)
+{
+    // Deflate all compressed pieces at once, the output buffers are capped like in write_compressed_chunk
+    piece_task tasks[MAX_SAVEGAME_PIECES];
+    int num_tasks = 0;
+    size_t total_size = 0;
+    for (int i = 0; i < num_pieces; i++) {
+        file_piece *piece = &pieces[i];
+        if (!piece->compressed || !piece->buf.size) {
+            continue;
+        }
+        piece_task *task = &tasks[num_tasks++];
+        task->piece = piece;
+        task->data_offset = total_size;
+        task->data_size = calc_bound(zlib_helper_compress_bound((int) piece->buf.size), 0,
+            COMPRESS_BUFFER_INITIAL_SIZE);
+        total_size += task->data_size;
+    }
+    if (core_memory_block_ensure_size(compress_buffer, total_size)) {
+        run_piece_tasks(tasks, num_tasks, compress_buffer->memory, compress_piece);
+    } else {
+        for (int i = 0; i < num_tasks; i++) {
+            tasks[i].result = 0;
+        }
+    }
+
+    uint8_t index_data[PIECE_INDEX_HEADER_SIZE + MAX_SAVEGAME_PIECES * PIECE_INDEX_ENTRY_SIZE];
+    buffer index;
+    buffer_init(&index, index_data, PIECE_INDEX_HEADER_SIZE + num_pieces * PIECE_INDEX_ENTRY_SIZE);
+    buffer_write_i32(&index, PIECE_INDEX_VERSION);
+    buffer_write_i32(&index, num_pieces);
+    long start = ftell(fp);
+    long index_position = 0;
+    piece_task *task = tasks;
+    for (int i = 0; i < num_pieces; i++) {
+        file_piece *piece = &pieces[i];
+        long piece_start = ftell(fp);
+        if (piece_index && i == piece_index) {
+            // Placeholder, the entries are only known once all pieces are written
+            write_int32(fp, (int) index.size);
+            index_position = ftell(fp);
+            fwrite(index_data, 1, index.size, fp);
+        } else if (piece->dynamic && !piece->buf.size) {
+            write_int32(fp, 0);
         } else {
-            fwrite(piece->buf.data, 1, piece->buf.size, fp);
+            if (piece->dynamic) {
+                write_int32(fp, (int) piece->buf.size);
+            }
+            if (!piece->compressed) {
+                fwrite(piece->buf.data, 1, piece->buf.size, fp);
+            } else if (task->result) {
+                write_int32(fp, task->data_size);
+                fwrite((uint8_t *) compress_buffer->memory + task->data_offset, 1, task->data_size, fp);
+                task++;
+            } else {
+                // unable to compress: write uncompressed
+                write_int32(fp, UNCOMPRESSED);
+                fwrite(piece->buf.data, 1, piece->buf.size, fp);
+                task++;
+            }
         }
+        if (piece_index) {
+            buffer_write_u32(&index, (uint32_t) (piece_start - start));
+            buffer_write_u32(&index, (uint32_t) (ftell(fp) - piece_start));
+            buffer_write_u32(&index, i != piece_index && piece->buf.size ?
+                zlib_helper_adler32(piece->buf.data, (int) piece->buf.size) : 0);
+        }
+    }
+    if (index_position) {
+        fseek(fp, index_position, SEEK_SET);
+        fwrite(index_data, 1, index.size, fp);
+        fseek(fp, 0, SEEK_END);
     }
 }
 
@@ -1509,6 +1786,7 @@ int game_file_io_read_save_game_from_buffer(buffer *buf)
 
 int game_file_io_read_saved_game(const char *filename, int offset)
 {
+    game_file_io_wait_for_save();
     log_info("Loading saved game", filename, 0);
     FILE *fp = file_open(filename, "rb");
     if (!fp) {
@@ -1697,7 +1975,13 @@ int game_file_io_read_saved_game_info(const char *filename, int offset, saved_ga
     }
     resource_set_mapping(resource_version);
     init_savegame_data(save_version);
-    result = savegame_read_from_file(fp, save_version);
+    long start = ftell(fp);
+    result = savegame_read_file_info_pieces_from_file(fp, save_version);
+    if (!result) {
+        // No usable piece index, read the whole file instead
+        init_savegame_data(save_version);
+        result = fseek(fp, start, SEEK_SET) == 0 && savegame_read_from_file(fp, save_version);
+    }
     file_close(fp);
     if (result != SAVEGAME_STATUS_OK) {
         return FILE_LOAD_WRONG_FILE_FORMAT;
@@ -1732,30 +2016,102 @@ int game_file_io_read_saved_game_info_from_buffer(buffer *buf, saved_game_info *
     return savegame_read_file_info(info, save_version);
 }
 
-int game_file_io_write_saved_game(const char *filename)
+static int write_pending_save(void *unused)
+{
+    savegame_write_to_file(pending_save.fp, pending_save.pieces, pending_save.num_pieces, pending_save.piece_index,
+        &pending_save.compress_buffer);
+    return !ferror(pending_save.fp);
+}
+
+static int finish_pending_save(int written)
+{
+    int result = file_close(pending_save.fp) && written &&
+        file_rename(pending_save.temp_filename, pending_save.filename);
+    pending_save.fp = 0;
+    if (!result) {
+        log_error("Unable to save game", pending_save.filename, 0);
+        file_remove(pending_save.temp_filename);
+    }
+    for (int i = 0; i < pending_save.num_pieces; i++) {
+        free(pending_save.pieces[i].buf.data);
+    }
+    pending_save.num_pieces = 0;
+    return result;
+}
+
+static int write_saved_game(const char *filename, int in_background)
 {
+    game_file_io_wait_for_save();
+
     resource_set_mapping(RESOURCE_CURRENT_VERSION);
     init_savegame_data(SAVE_GAME_CURRENT_VERSION);
 
     log_info("Saving game", filename, 0);
     savegame_save_to_state(&savegame_data.state);
 
-    FILE *fp = file_open(filename, "wb");
-    if (!fp) {
+    snprintf(pending_save.temp_filename, FILE_NAME_MAX, "%s.tmp", filename);
+    pending_save.fp = file_open(pending_save.temp_filename, "wb");
+    if (!pending_save.fp) {
         log_error("Unable to save game", 0, 0);
+        clear_savegame_pieces();
         return 0;
     }
-    memory_block compress_buffer;
-    core_memory_block_init(&compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE);
-    savegame_write_to_file(fp, &compress_buffer);
-    core_memory_block_free(&compress_buffer);
-    clear_savegame_pieces();
-    file_close(fp);
-    return 1;
+    if (!pending_save.compress_buffer.memory &&
+        !core_memory_block_init(&pending_save.compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE)) {
+        log_error("Unable to save game, out of memory", 0, 0);
+        file_close(pending_save.fp);
+        file_remove(pending_save.temp_filename);
+        clear_savegame_pieces();
+        return 0;
+    }
+    snprintf(pending_save.filename, FILE_NAME_MAX, "%s", filename);
+
+    // The snapshot is handed over to the writer, the next save allocates fresh pieces
+    memcpy(pending_save.pieces, savegame_data.pieces, sizeof(file_piece) * savegame_data.num_pieces);
+    pending_save.num_pieces = savegame_data.num_pieces;
+    pending_save.piece_index = savegame_data.piece_index;
+    savegame_data.num_pieces = 0;
+
+    if (in_background) {
+        pending_save.thread = system_thread_start(write_pending_save, 0);
+        if (pending_save.thread) {
+            return 1;
+        }
+    }
+    return finish_pending_save(write_pending_save(0));
+}
+
+int game_file_io_write_saved_game(const char *filename)
+{
+    return write_saved_game(filename, 0);
+}
+
+int game_file_io_write_saved_game_in_background(const char *filename)
+{
+    return write_saved_game(filename, 1);
+}
+
+int game_file_io_is_saving(void)
+{
+    if (pending_save.thread && system_thread_is_finished(pending_save.thread)) {
+        game_file_io_wait_for_save();
+    }
+    return pending_save.thread != 0;
+}
+
+void game_file_io_wait_for_save(void)
+{
+    if (!pending_save.thread) {
+        return;
+    }
+    int written = system_thread_wait(pending_save.thread);
+    pending_save.thread = 0;
+    finish_pending_save(written);
 }
 
 int game_file_io_delete_saved_game(const char *filename)
 {
+    game_file_io_wait_for_save();
     log_info("Deleting game", filename, 0);
     int result = file_remove(filename);
     if (!result) {
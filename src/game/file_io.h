@@ -53,6 +53,25 @@ int game_file_io_read_saved_game_info_from_buffer(buffer *buf, saved_game_info *
 
 int game_file_io_write_saved_game(const char *filename);
 
+/**
+ * Saves the game state to memory and writes it to the file on a background thread.
+ * The file is written under a temporary name and renamed once complete.
+ * @param filename File to save to
+ * @return 1 if the save was started, 0 otherwise
+ */
+int game_file_io_write_saved_game_in_background(const char *filename);
+
+/**
+ * Checks whether a background save is still being written, finishing it if the writer is done
+ * @return 1 if a save is in flight, 0 otherwise
+ */
+int game_file_io_is_saving(void);
+
+/**
+ * Waits for a background save to be written
+ */
+void game_file_io_wait_for_save(void);
+
 int game_file_io_delete_saved_game(const char *filename);
 
 #endif // GAME_FILE_IO_H
@@ -18,6 +18,8 @@
 #include "game/campaign.h"
 #include "game/file.h"
 #include "game/file_editor.h"
+#include "game/file_io.h"
+#include "game/profiler.h"
 #include "game/settings.h"
 #include "game/speed.h"
 #include "game/state.h"
@@ -39,6 +41,8 @@
 #include "window/logo.h"
 #include "window/main_menu.h"
 
+#include <stdio.h>
+
 static void errlog(const char *msg)
 {
     log_error(msg, 0, 0);
@@ -203,6 +207,8 @@ int game_reload_language(void)
 
 void game_run(void)
 {
+    // Completes a background save once it has been written
+    game_file_io_is_saving();
     game_animation_update();
     int num_ticks = game_speed_get_elapsed_ticks();
     for (int i = 0; i < num_ticks; i++) {
@@ -232,8 +238,32 @@ void game_display_fps(int fps)
     text_draw_number_centered_colored(fps, x_offset, y_offset + 6, width, FONT_SMALL_PLAIN, COLOR_BLACK);
 }
 
+#define PROFILER_PANEL_ROWS 10
+
+void game_display_profiler(void)
+{
+    profiler_section_stats stats[PROFILER_PANEL_ROWS];
+    int rows = game_profiler_get_top_sections(stats, PROFILER_PANEL_ROWS);
+    int x_offset = 8;
+    int y_offset = 50;
+    int width = 320;
+    int height = 20 + 14 * rows;
+    graphics_draw_rect(x_offset, y_offset, width + 2, height + 2, COLOR_BLACK);
+    graphics_fill_rect(x_offset + 1, y_offset + 1, width, height, COLOR_WHITE);
+    text_draw(string_from_ascii("Slowest jobs (avg / p99 / max us)"),
+        x_offset + 6, y_offset + 6, FONT_SMALL_PLAIN, COLOR_BLACK);
+    for (int i = 0; i < rows; i++) {
+        char line[100];
+        snprintf(line, sizeof(line), "%.40s: %llu / %llu / %llu", stats[i].name,
+            (unsigned long long) (stats[i].total_micros / stats[i].samples),
+            (unsigned long long) stats[i].p99_micros, (unsigned long long) stats[i].max_micros);
+        text_draw(string_from_ascii(line), x_offset + 6, y_offset + 20 + 14 * i, FONT_SMALL_PLAIN, COLOR_BLACK);
+    }
+}
+
 void game_exit(void)
 {
+    game_file_io_wait_for_save();
     video_shutdown();
     settings_save();
     config_save();
@@ -0,0 +1,243 @@
+#include "profiler.h"
+
+#include "core/log.h"
+#include "figure/type.h"
+#include "game/tick.h"
+#include "game/time.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_NAMED_SECTIONS 128
+#define FIGURE_TYPE_SECTIONS MAX_NAMED_SECTIONS
+#define MAX_SECTIONS (FIGURE_TYPE_SECTIONS + FIGURE_TYPE_MAX)
+#define GENERATED_NAME_LENGTH 20
+
+typedef struct {
+    const char *name;
+    uint32_t window[PROFILER_WINDOW_SIZE];
+    int next;
+    int samples;
+    int histogram[PROFILER_HISTOGRAM_BUCKETS];
+} section;
+
+static struct {
+    int enabled;
+    int num_named_sections;
+    section sections[MAX_SECTIONS];
+    char figure_type_names[FIGURE_TYPE_MAX][GENERATED_NAME_LENGTH];
+    char tick_slot_names[GAME_TIME_TICKS_PER_DAY][GENERATED_NAME_LENGTH];
+} data;
+
+static void reset_section(section *s)
+{
+    const char *name = s->name;
+    memset(s, 0, sizeof(section));
+    s->name = name;
+}
+
+void game_profiler_enable(int enabled)
+{
+    if (enabled && !data.enabled) {
+        for (int i = 0; i < MAX_SECTIONS; i++) {
+            reset_section(&data.sections[i]);
+        }
+    }
+    if (enabled != data.enabled) {
+        game_tick_profile_enable(enabled);
+    }
+    data.enabled = enabled;
+}
+
+int game_profiler_is_enabled(void)
+{
+    return data.enabled;
+}
+
+int game_profiler_histogram_bucket(time_micros micros)
+{
+    int bucket = 0;
+    while (bucket < PROFILER_HISTOGRAM_BUCKETS - 1 && micros >= (1u << bucket)) {
+        bucket++;
+    }
+    return bucket;
+}
+
+static void record(section *s, time_micros micros)
+{
+    uint32_t sample = micros > UINT32_MAX ? UINT32_MAX : (uint32_t) micros;
+    if (s->samples == PROFILER_WINDOW_SIZE) {
+        s->histogram[game_profiler_histogram_bucket(s->window[s->next])]--;
+    } else {
+        s->samples++;
+    }
+    s->window[s->next] = sample;
+    s->histogram[game_profiler_histogram_bucket(sample)]++;
+    s->next = (s->next + 1) % PROFILER_WINDOW_SIZE;
+}
+
+time_micros game_profiler_start(int *section_id, const char *name)
+{
+    if (!data.enabled) {
+        return 0;
+    }
+    if (!*section_id) {
+        if (data.num_named_sections >= MAX_NAMED_SECTIONS - 1) {
+            return 0;
+        }
+        *section_id = ++data.num_named_sections;
+        data.sections[*section_id].name = name;
+    }
+    return time_get_micros();
+}
+
+void game_profiler_stop(int section_id, time_micros start)
+{
+    if (!data.enabled || !start || !section_id) {
+        return;
+    }
+    record(&data.sections[section_id], time_get_micros() - start);
+}
+
+void game_profiler_record_figure_type(int type, time_micros micros)
+{
+    if (!data.enabled || type <= FIGURE_NONE || type >= FIGURE_TYPE_MAX) {
+        return;
+    }
+    section *s = &data.sections[FIGURE_TYPE_SECTIONS + type];
+    if (!s->name) {
+        snprintf(data.figure_type_names[type], GENERATED_NAME_LENGTH, "figure type %d", type);
+        s->name = data.figure_type_names[type];
+    }
+    record(s, micros);
+}
+
+static int compare_samples(const void *a, const void *b)
+{
+    uint32_t va = *(const uint32_t *) a;
+    uint32_t vb = *(const uint32_t *) b;
+    return va < vb ? -1 : va > vb;
+}
+
+static void get_stats(const section *s, profiler_section_stats *stats)
+{
+    uint32_t sorted[PROFILER_WINDOW_SIZE];
+    stats->name = s->name;
+    stats->samples = s->samples;
+    stats->total_micros = 0;
+    for (int i = 0; i < s->samples; i++) {
+        stats->total_micros += s->window[i];
+        sorted[i] = s->window[i];
+    }
+    qsort(sorted, s->samples, sizeof(uint32_t), compare_samples);
+    stats->max_micros = sorted[s->samples - 1];
+    stats->p99_micros = sorted[(s->samples * 99 + 99) / 100 - 1];
+    memcpy(stats->histogram, s->histogram, sizeof(stats->histogram));
+}
+
+static void get_tick_slot_stats(int tick, const game_tick_slot_profile *slot, profiler_section_stats *stats)
+{
+    if (!data.tick_slot_names[tick][0]) {
+        snprintf(data.tick_slot_names[tick], GENERATED_NAME_LENGTH, "tick slot %d", tick);
+    }
+    stats->name = data.tick_slot_names[tick];
+    stats->samples = (int) slot->calls;
+    stats->total_micros = slot->total_micros;
+    stats->max_micros = slot->max_micros;
+    // Only a histogram is kept for the slots, so use the upper bound of the bucket holding the 99th percentile
+    unsigned int p99_count = (slot->calls * 99 + 99) / 100;
+    unsigned int count = 0;
+    stats->p99_micros = 0;
+    for (int b = 0; b < PROFILER_HISTOGRAM_BUCKETS; b++) {
+        stats->histogram[b] = (int) slot->histogram[b];
+        count += slot->histogram[b];
+        if (!stats->p99_micros && count >= p99_count) {
+            time_micros bucket_limit = (time_micros) 1 << b;
+            int is_last_bucket = b == PROFILER_HISTOGRAM_BUCKETS - 1;
+            stats->p99_micros = is_last_bucket || bucket_limit > slot->max_micros ? slot->max_micros : bucket_limit;
+        }
+    }
+}
+
+static time_micros average(const profiler_section_stats *stats)
+{
+    return stats->total_micros / stats->samples;
+}
+
+static int add_top_section(profiler_section_stats *stats, int count, int max_sections,
+    const profiler_section_stats *current)
+{
+    int index = count;
+    if (count < max_sections) {
+        count++;
+    } else if (average(&stats[count - 1]) < average(current)) {
+        index = count - 1;
+    } else {
+        return count;
+    }
+    while (index > 0 && average(&stats[index - 1]) < average(current)) {
+        stats[index] = stats[index - 1];
+        index--;
+    }
+    stats[index] = *current;
+    return count;
+}
+
+int game_profiler_get_top_sections(profiler_section_stats *stats, int max_sections)
+{
+    if (max_sections <= 0) {
+        return 0;
+    }
+    int count = 0;
+    profiler_section_stats current;
+    for (int i = 0; i < MAX_SECTIONS; i++) {
+        const section *s = &data.sections[i];
+        if (s->samples) {
+            get_stats(s, &current);
+            count = add_top_section(stats, count, max_sections, &current);
+        }
+    }
+    const game_tick_slot_profile *slots = game_tick_profile_slots();
+    for (int tick = 0; tick < GAME_TIME_TICKS_PER_DAY; tick++) {
+        if (slots[tick].calls) {
+            get_tick_slot_stats(tick, &slots[tick], &current);
+            count = add_top_section(stats, count, max_sections, &current);
+        }
+    }
+    return count;
+}
+
+static void log_stats(const profiler_section_stats *stats)
+{
+    char line[256];
+    int length = snprintf(line, sizeof(line), "%s: %d samples, avg %llu, p99 %llu, max %llu, histogram",
+        stats->name, stats->samples, (unsigned long long) average(stats),
+        (unsigned long long) stats->p99_micros, (unsigned long long) stats->max_micros);
+    for (int b = 0; b < PROFILER_HISTOGRAM_BUCKETS && length > 0 && length < (int) sizeof(line); b++) {
+        length += snprintf(line + length, sizeof(line) - length, " %d", stats->histogram[b]);
+    }
+    log_info(line, 0, 0);
+}
+
+void game_profiler_dump(void)
+{
+    log_info("Profiler results, microseconds over the last samples of each section:", 0, 0);
+    profiler_section_stats stats;
+    for (int i = 0; i < MAX_SECTIONS; i++) {
+        const section *s = &data.sections[i];
+        if (s->samples) {
+            get_stats(s, &stats);
+            log_stats(&stats);
+        }
+    }
+    log_info("Tick slots, microseconds since the profiler was enabled:", 0, 0);
+    const game_tick_slot_profile *slots = game_tick_profile_slots();
+    for (int tick = 0; tick < GAME_TIME_TICKS_PER_DAY; tick++) {
+        if (slots[tick].calls) {
+            get_tick_slot_stats(tick, &slots[tick], &stats);
+            log_stats(&stats);
+        }
+    }
+}
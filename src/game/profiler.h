@@ -0,0 +1,85 @@
+#ifndef GAME_PROFILER_H
+#define GAME_PROFILER_H
+
+#include "core/time.h"
+
+/**
+ * @file
+ * Lightweight profiler for the simulation jobs.
+ * Keeps a rolling window of the most recent timings of every section.
+ * The jobs of each tick of the day are timed by game/tick itself and reported here as well.
+ */
+
+#define PROFILER_WINDOW_SIZE 128
+#define PROFILER_HISTOGRAM_BUCKETS 16
+
+typedef struct {
+    const char *name;
+    int samples;
+    time_micros total_micros;
+    time_micros max_micros;
+    time_micros p99_micros;
+    /** Bucket n counts the samples that took less than 2^n microseconds, the last bucket counts the rest */
+    int histogram[PROFILER_HISTOGRAM_BUCKETS];
+} profiler_section_stats;
+
+/**
+ * Times a job in a named section when the profiler is enabled
+ * @param name Name of the section, must be a string literal
+ * @param job Statement to time
+ */
+#define PROFILER_TIME(name, job) \
+    do { \
+        static int profiler_section_id; \
+        time_micros profiler_start = game_profiler_start(&profiler_section_id, name); \
+        job; \
+        game_profiler_stop(profiler_section_id, profiler_start); \
+    } while (0)
+
+void game_profiler_enable(int enabled);
+
+int game_profiler_is_enabled(void);
+
+/**
+ * Starts timing a section, registering it on first use
+ * @param section_id Section id, zero when the section has not been registered yet
+ * @param name Name of the section
+ * @return Start time, or zero when the profiler is disabled
+ */
+time_micros game_profiler_start(int *section_id, const char *name);
+
+/**
+ * Stops timing a section and records the sample
+ * @param section_id Section id returned through game_profiler_start
+ * @param start Start time returned by game_profiler_start
+ */
+void game_profiler_stop(int section_id, time_micros start);
+
+/**
+ * Gets the histogram bucket of a sample
+ * @param micros Time spent
+ * @return Bucket index, below PROFILER_HISTOGRAM_BUCKETS
+ */
+int game_profiler_histogram_bucket(time_micros micros);
+
+/**
+ * Records the time spent in the actions of one figure type during this tick
+ * @param figure_type Figure type
+ * @param micros Time spent
+ */
+void game_profiler_record_figure_type(int figure_type, time_micros micros);
+
+/**
+ * Gets the sections with the largest average time
+ * @param stats Array to fill, sorted by descending average time
+ * @param max_sections Size of the array
+ * @return Number of sections filled
+ */
+int game_profiler_get_top_sections(profiler_section_stats *stats, int max_sections);
+
+/**
+ * Writes the statistics of all sections to the log
+ */
+void game_profiler_dump(void);
+
+#endif // GAME_PROFILER_H
@@ -2,7 +2,7 @@
 #define GAME_SAVE_VERSION_H
 
 typedef enum {
-    SAVE_GAME_CURRENT_VERSION = 0x9f,
+    SAVE_GAME_CURRENT_VERSION = 0xa0,
 
     SAVE_GAME_LAST_ORIGINAL_LIMITS_VERSION = 0x66,
     SAVE_GAME_LAST_SMALLER_IMAGE_ID_VERSION = 0x76,
@@ -41,7 +41,8 @@ typedef enum {
     SAVE_GAME_LAST_WRONG_SCENARIO_END_OFFSET = 0x9b,
     SAVE_GAME_LAST_NO_CUSTOM_EMPIRE_MAP_IMAGE = 0x9c,
     SAVE_GAME_LAST_NO_CUSTOM_CAMPAIGNS = 0x9d,
-    SAVE_GAME_LAST_STATIC_SCENARIO_ORIGINAL_DATA = 0x9e
+    SAVE_GAME_LAST_STATIC_SCENARIO_ORIGINAL_DATA = 0x9e,
+    SAVE_GAME_LAST_NO_PIECE_INDEX = 0x9f
 } savegame_version_t;
 
 typedef enum {
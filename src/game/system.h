@@ -211,4 +211,34 @@ const char *system_show_select_folder_dialog(const char *title, const char *defa
  */
 void system_exit(void);
 
+/**
+ * Gets the number of logical CPU cores
+ * @return Number of cores, at least 1
+ */
+int system_get_cpu_count(void);
+
+typedef struct system_thread system_thread;
+
+/**
+ * Starts a background thread
+ * @param function Function to run on the thread
+ * @param data Data to pass to the function
+ * @return The thread, or 0 if the platform cannot run it in the background
+ */
+system_thread *system_thread_start(int (*function)(void *data), void *data);
+
+/**
+ * Checks whether a background thread has finished running its function
+ * @param thread The thread
+ * @return 1 if the function returned, 0 otherwise
+ */
+int system_thread_is_finished(system_thread *thread);
+
+/**
+ * Waits for a background thread to finish and releases it
+ * @param thread The thread
+ * @return The value returned by the thread function
+ */
+int system_thread_wait(system_thread *thread);
+
 #endif // GAME_SYSTEM_H
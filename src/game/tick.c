@@ -39,11 +39,13 @@
 #include "figure/formation.h"
 #include "figuretype/crime.h"
 #include "game/file.h"
+#include "game/profiler.h"
 #include "game/settings.h"
 #include "game/time.h"
 #include "game/tutorial.h"
 #include "game/undo.h"
 #include "map/desirability.h"
+#include "map/grid.h"
 #include "map/natives.h"
 #include "map/road_network.h"
 #include "map/routing_terrain.h"
@@ -63,6 +65,48 @@
 #include "sound/music.h"
 #include "widget/minimap.h"
 
+#include <string.h>
+
+#define MAP_UPDATE_ROWS_PER_TICK ((GRID_SIZE + GAME_TIME_TICKS_PER_DAY - 1) / GAME_TIME_TICKS_PER_DAY)
+
+static struct {
+    int enabled;
+    game_tick_slot_profile slots[GAME_TIME_TICKS_PER_DAY];
+} profile;
+
+static struct {
+    int in_progress;
+    int next_row;
+} pending_map_update;
+
+static void update_map_rows(int rows)
+{
+    if (!pending_map_update.next_row) {
+        building_connectable_update_connections();
+    }
+    int y_min = pending_map_update.next_row;
+    int y_max = y_min + rows - 1;
+    map_tiles_update_region_roads_except_aqueducts(0, y_min, GRID_SIZE, y_max);
+    map_tiles_update_region_highways_except_aqueducts(0, y_min, GRID_SIZE, y_max);
+    map_tiles_update_region_water(0, y_min, GRID_SIZE, y_max);
+    pending_map_update.next_row = y_max + 1;
+    if (pending_map_update.next_row >= map_grid_height()) {
+        pending_map_update.in_progress = 0;
+    }
+}
+
+void game_tick_finish_pending_map_updates(void)
+{
+    if (pending_map_update.in_progress) {
+        update_map_rows(GRID_SIZE);
+    }
+}
+
+void game_tick_clear_pending_map_updates(void)
+{
+    pending_map_update.in_progress = 0;
+}
+
 static void advance_year(void)
 {
     game_undo_disable();
@@ -78,50 +122,61 @@ static void advance_year(void)
 static void advance_month(void)
 {
     int new_year = 0;
-    city_migration_reset_newcomers();
-    city_health_update();
-    scenario_random_event_process();
-    city_finance_handle_month_change();
-    city_resource_consume_food();
-    scenario_distant_battle_process();
-    scenario_invasion_process();
-    scenario_request_process();
-    scenario_demand_change_process();
-    scenario_price_change_process();
-    city_victory_update_months_to_govern();
-    formation_update_monthly_morale_at_rest();
-    city_message_decrease_delays();
-    city_sentiment_decrement_blessing_boost();
-    building_industry_advance_stats();
-    building_industry_start_strikes();
-    building_trim();
-
-    building_connectable_update_connections();
-    map_tiles_update_all_roads();
-    map_tiles_update_all_highways();
-    map_tiles_update_all_water();
-    map_routing_update_land_citizen();
-    city_message_sort_and_compact();
+    PROFILER_TIME("city_migration_reset_newcomers", city_migration_reset_newcomers());
+    PROFILER_TIME("city_health_update", city_health_update());
+    PROFILER_TIME("scenario_random_event_process", scenario_random_event_process());
+    PROFILER_TIME("city_finance_handle_month_change", city_finance_handle_month_change());
+    PROFILER_TIME("city_resource_consume_food", city_resource_consume_food());
+    PROFILER_TIME("scenario_distant_battle_process", scenario_distant_battle_process());
+    PROFILER_TIME("scenario_invasion_process", scenario_invasion_process());
+    PROFILER_TIME("scenario_request_process", scenario_request_process());
+    PROFILER_TIME("scenario_demand_change_process", scenario_demand_change_process());
+    PROFILER_TIME("scenario_price_change_process", scenario_price_change_process());
+    PROFILER_TIME("city_victory_update_months_to_govern", city_victory_update_months_to_govern());
+    PROFILER_TIME("formation_update_monthly_morale_at_rest", formation_update_monthly_morale_at_rest());
+    PROFILER_TIME("city_message_decrease_delays", city_message_decrease_delays());
+    PROFILER_TIME("city_sentiment_decrement_blessing_boost", city_sentiment_decrement_blessing_boost());
+    PROFILER_TIME("building_industry_advance_stats", building_industry_advance_stats());
+    PROFILER_TIME("building_industry_start_strikes", building_industry_start_strikes());
+    PROFILER_TIME("building_trim", building_trim());
+
+    if (config_get(CONFIG_GENERAL_SPREAD_MONTHLY_MAP_UPDATES)) {
+        // Only images are refreshed here, so they can be spread over the ticks of the next day.
+        // The aqueduct images are still refreshed now, as the land routing update below reads them.
+        game_tick_finish_pending_map_updates();
+        PROFILER_TIME("map_tiles_update_all_road_aqueducts", map_tiles_update_all_road_aqueducts());
+        pending_map_update.in_progress = 1;
+        pending_map_update.next_row = 0;
+    } else {
+        PROFILER_TIME("building_connectable_update_connections", building_connectable_update_connections());
+        PROFILER_TIME("map_tiles_update_all_roads", map_tiles_update_all_roads());
+        PROFILER_TIME("map_tiles_update_all_highways", map_tiles_update_all_highways());
+        PROFILER_TIME("map_tiles_update_all_water", map_tiles_update_all_water());
+    }
+    PROFILER_TIME("map_routing_update_land_citizen", map_routing_update_land_citizen());
+    PROFILER_TIME("city_message_sort_and_compact", city_message_sort_and_compact());
 
     if (game_time_advance_month()) {
-        advance_year();
+        PROFILER_TIME("advance_year", advance_year());
         new_year = 1;
     } else {
-        city_ratings_update(0,1);
+        PROFILER_TIME("city_ratings_update", city_ratings_update(0,1));
     }
 
-    city_population_record_monthly();
-    city_festival_update();
-    city_games_decrement_month_counts();
-    city_gods_update_blessings();
-    tutorial_on_month_tick();
-    scenario_events_progress_paused(1);
-    scenario_events_process_all();
+    PROFILER_TIME("city_population_record_monthly", city_population_record_monthly());
+    PROFILER_TIME("city_festival_update", city_festival_update());
+    PROFILER_TIME("city_games_decrement_month_counts", city_games_decrement_month_counts());
+    PROFILER_TIME("city_gods_update_blessings", city_gods_update_blessings());
+    PROFILER_TIME("tutorial_on_month_tick", tutorial_on_month_tick());
+    PROFILER_TIME("scenario_events_progress_paused", scenario_events_progress_paused(1));
+    PROFILER_TIME("scenario_events_process_all", scenario_events_process_all());
     if (setting_monthly_autosave()) {
-        game_file_write_saved_game(dir_append_location("autosave.svx", PATH_LOCATION_SAVEGAME));
+        PROFILER_TIME("monthly autosave",
+            game_file_write_saved_game_in_background(dir_append_location("autosave.svx", PATH_LOCATION_SAVEGAME)));
     }
     if (new_year && config_get(CONFIG_GP_CH_YEARLY_AUTOSAVE)) {
-        game_file_write_saved_game(dir_append_location("autosave-year.svx", PATH_LOCATION_SAVEGAME));
+        PROFILER_TIME("yearly autosave",
+            game_file_write_saved_game_in_background(dir_append_location("autosave-year.svx", PATH_LOCATION_SAVEGAME)));
     }
 }
 
@@ -131,12 +186,12 @@ static void advance_day(void)
         advance_month();
     }
     if (game_time_day() == 0 || game_time_day() == 8) {
-        city_sentiment_update();
+        PROFILER_TIME("city_sentiment_update", city_sentiment_update());
     }
     if (game_time_day() == 0 || game_time_day() == 7) {
-        building_lighthouse_consume_timber();
+        PROFILER_TIME("building_lighthouse_consume_timber", building_lighthouse_consume_timber());
     }
-    tutorial_on_day_tick();
+    PROFILER_TIME("tutorial_on_day_tick", tutorial_on_day_tick());
 }
 
 static void advance_tick(void)
@@ -144,7 +199,12 @@ static void advance_tick(void)
     // NB: these ticks are noop:
     // 0, 10, 11, 13, 14, 15, 18, 26, 41
     // max is 49
-    switch (game_time_tick()) {
+    if (pending_map_update.in_progress) {
+        PROFILER_TIME("pending map updates", update_map_rows(MAP_UPDATE_ROWS_PER_TICK));
+    }
+    int tick = game_time_tick();
+    time_micros start = profile.enabled ? time_get_micros() : 0;
+    switch (tick) {
         case 1: city_gods_calculate_moods(1); break;
         case 2: sound_music_update(0); break;
         case 3: widget_minimap_invalidate(); break;
@@ -187,6 +247,16 @@ static void advance_tick(void)
         case 48: house_service_decay_tax_collector(); break;
         case 49: city_culture_calculate(); break;
     }
+    if (profile.enabled) {
+        time_micros duration = time_get_micros() - start;
+        game_tick_slot_profile *slot = &profile.slots[tick];
+        slot->total_micros += duration;
+        slot->calls++;
+        if (duration > slot->max_micros) {
+            slot->max_micros = duration;
+        }
+        slot->histogram[game_profiler_histogram_bucket(duration)]++;
+    }
     if (game_time_advance_tick()) {
         advance_day();
     }
@@ -202,13 +272,26 @@ void game_tick_run(void)
     random_generate_next();
     game_undo_reduce_time_available();
     advance_tick();
-    figure_action_handle();
+    PROFILER_TIME("figure_action_handle", figure_action_handle());
     scenario_earthquake_process();
     scenario_gladiator_revolt_process();
     scenario_emperor_change_process();
     city_victory_check();
 }
 
+void game_tick_profile_enable(int enabled)
+{
+    if (enabled) {
+        memset(profile.slots, 0, sizeof(profile.slots));
+    }
+    profile.enabled = enabled;
+}
+
+const game_tick_slot_profile *game_tick_profile_slots(void)
+{
+    return profile.slots;
+}
+
 void game_tick_cheat_year(void)
 {
     advance_year();
@@ -1,8 +1,42 @@
 #ifndef GAME_TICK_H
 #define GAME_TICK_H
 
+#include "core/time.h"
+#include "game/profiler.h"
+
+typedef struct {
+    time_micros total_micros;
+    time_micros max_micros;
+    unsigned int calls;
+    /** Bucket n counts the calls that took less than 2^n microseconds, the last bucket counts the rest */
+    unsigned int histogram[PROFILER_HISTOGRAM_BUCKETS];
+} game_tick_slot_profile;
+
 void game_tick_run(void);
 
+/**
+ * Finishes the monthly map image updates that are being spread over the current day
+ */
+void game_tick_finish_pending_map_updates(void);
+
+/**
+ * Drops the monthly map image updates that are being spread over the current day
+ */
+void game_tick_clear_pending_map_updates(void);
+
+/**
+ * Starts or stops timing the jobs scheduled on each tick of the day.
+ * Starting resets the collected times.
+ * @param enabled Whether to time the jobs
+ */
+void game_tick_profile_enable(int enabled);
+
+/**
+ * Gets the time spent in the jobs of each tick of the day
+ * @return Array of GAME_TIME_TICKS_PER_DAY entries, indexed by tick
+ */
+const game_tick_slot_profile *game_tick_profile_slots(void);
+
 void game_tick_cheat_year(void);
 
 #endif // GAME_TICK_H
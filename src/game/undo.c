@@ -2,6 +2,7 @@
 
 #include "building/construction.h"
 #include "building/house.h"
+#include "building/house_population.h"
 #include "building/image.h"
 #include "building/industry.h"
 #include "building/menu.h"
@@ -146,6 +147,9 @@ void game_undo_restore_building_state(void)
             building *b = building_get(data.buildings[i].id);
             if (b->state == BUILDING_STATE_DELETED_BY_PLAYER) {
                 b->state = BUILDING_STATE_IN_USE;
+                if (building_is_house(b->type)) {
+                    house_population_mark_index_changed();
+                }
             }
             b->is_deleted = 0;
         }
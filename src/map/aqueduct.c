@@ -1,6 +1,7 @@
 #include "aqueduct.h"
 
 #include "map/grid.h"
+#include "map/water_supply.h"
 
 #define WATER_ACCESS_OFFSET 7
 #define IMAGE_MASK 0x7f
@@ -31,6 +32,7 @@ void map_aqueduct_set_image(int grid_offset, int value)
 void map_aqueduct_remove(int grid_offset)
 {
     aqueduct.items[grid_offset] = 0;
+    map_water_supply_mark_aqueducts_changed();
     if (map_aqueduct_image_at(grid_offset + map_grid_delta(0, -1)) == 5) {
         map_aqueduct_set_image(grid_offset + map_grid_delta(0, -1), 1);
     }
@@ -48,6 +50,7 @@ void map_aqueduct_remove(int grid_offset)
 void map_aqueduct_clear(void)
 {
     map_grid_clear_u8(aqueduct.items);
+    map_water_supply_mark_aqueducts_changed();
 }
 
 void map_aqueduct_backup(void)
@@ -58,6 +61,7 @@ void map_aqueduct_backup(void)
 void map_aqueduct_restore(void)
 {
     map_grid_copy_u8(aqueduct_backup.items, aqueduct.items);
+    map_water_supply_mark_aqueducts_changed();
 }
 
 void map_aqueduct_save_state(buffer *buf, buffer *backup)
@@ -70,4 +74,5 @@ void map_aqueduct_load_state(buffer *buf, buffer *backup)
 {
     map_grid_load_state_u8(aqueduct.items, buf);
     map_grid_load_state_u8(aqueduct_backup.items, backup);
+    map_water_supply_mark_aqueducts_changed();
 }
@@ -3,6 +3,8 @@
 #include "building/building.h"
 #include "core/config.h"
 #include "map/grid.h"
+#include "map/image.h"
+#include "map/water_supply.h"
 
 static grid_u16 buildings_grid;
 static grid_u8 damage_grid;
@@ -21,7 +23,11 @@ int map_building_from_buffer(buffer *buildings, int grid_offset)
 
 void map_building_set(int grid_offset, int building_id)
 {
-    buildings_grid.items[grid_offset] = building_id;
+    if (buildings_grid.items[grid_offset] != building_id) {
+        buildings_grid.items[grid_offset] = building_id;
+        map_water_supply_mark_aqueducts_changed();
+        map_image_mark_changed();
+    }
 }
 
 void map_building_damage_clear(int grid_offset)
@@ -47,6 +53,8 @@ void map_set_rubble_building_type(int grid_offset, building_type type)
 void map_building_clear(void)
 {
     map_grid_clear_u16(buildings_grid.items);
+    map_water_supply_mark_aqueducts_changed();
+    map_image_mark_changed();
     map_grid_clear_u8(damage_grid.items);
     map_grid_clear_u8(rubble_type_grid.items);
 }
@@ -60,6 +68,8 @@ void map_building_save_state(buffer *buildings, buffer *damage)
 void map_building_load_state(buffer *buildings, buffer *damage)
 {
     map_grid_load_state_u16(buildings_grid.items, buildings);
+    map_water_supply_mark_aqueducts_changed();
+    map_image_mark_changed();
     map_grid_load_state_u8(damage_grid.items, damage);
 }
 
@@ -10,6 +10,9 @@
 #include "map/ring.h"
 #include "map/terrain.h"
 
+// [rlaw]: hack desirability to max
+#define HACK_DESIRABILITY_TO_MAX 1
+
 static grid_i8 desirability_grid;
 
 void map_desirability_clear(void)
@@ -192,14 +195,30 @@ static void update_terrain(void)
     }
 }
 
+static void clear_invalid_plaza_earthquake_flags(void)
+{
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
+            if (map_property_is_plaza_earthquake_or_overgrown_garden(grid_offset) &&
+                !map_terrain_is(grid_offset, TERRAIN_ROAD | TERRAIN_ROCK | TERRAIN_GARDEN)) {
+                map_property_clear_plaza_earthquake_or_overgrown_garden(grid_offset);
+            }
+        }
+    }
+}
+
 void map_desirability_update(void)
 {
+    if (HACK_DESIRABILITY_TO_MAX) {
+        // Every calculated value would be overwritten, so only keep the flag cleanup done by update_terrain()
+        clear_invalid_plaza_earthquake_flags();
+        map_grid_init_i8(desirability_grid.items, 100);
+        return;
+    }
     map_desirability_clear();
     update_buildings();
     update_terrain();
-
-    // [rlaw]: hack desirability to max
-    map_grid_init_i8(desirability_grid.items, 100);
 }
 
 int map_desirability_get(int grid_offset)
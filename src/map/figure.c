@@ -2,8 +2,77 @@
 
 #include "map/grid.h"
 
+#include <string.h>
+
+#define BUCKET_SIZE 8
+#define BUCKETS_PER_ROW ((GRID_SIZE + BUCKET_SIZE - 1) / BUCKET_SIZE)
+#define NUM_BUCKETS (BUCKETS_PER_ROW * BUCKETS_PER_ROW)
+
 static grid_u16 figures;
 
+static struct {
+    unsigned short first_figure_id[NUM_BUCKETS];
+    int needs_rebuild;
+} buckets;
+
+static int bucket_for_offset(int grid_offset)
+{
+    int x = map_grid_offset_to_x(grid_offset) / BUCKET_SIZE;
+    int y = map_grid_offset_to_y(grid_offset) / BUCKET_SIZE;
+    return y * BUCKETS_PER_ROW + x;
+}
+
+static void remove_from_bucket(figure *f)
+{
+    if (!f->bucket_id) {
+        return;
+    }
+    if (f->previous_figure_id_in_bucket) {
+        figure_get(f->previous_figure_id_in_bucket)->next_figure_id_in_bucket = f->next_figure_id_in_bucket;
+    } else {
+        buckets.first_figure_id[f->bucket_id - 1] = f->next_figure_id_in_bucket;
+    }
+    if (f->next_figure_id_in_bucket) {
+        figure_get(f->next_figure_id_in_bucket)->previous_figure_id_in_bucket = f->previous_figure_id_in_bucket;
+    }
+    f->bucket_id = 0;
+    f->next_figure_id_in_bucket = 0;
+    f->previous_figure_id_in_bucket = 0;
+}
+
+static void add_to_bucket(figure *f)
+{
+    remove_from_bucket(f);
+    int bucket = bucket_for_offset(f->grid_offset);
+    f->bucket_id = bucket + 1;
+    f->previous_figure_id_in_bucket = 0;
+    f->next_figure_id_in_bucket = buckets.first_figure_id[bucket];
+    if (f->next_figure_id_in_bucket) {
+        figure_get(f->next_figure_id_in_bucket)->previous_figure_id_in_bucket = f->id;
+    }
+    buckets.first_figure_id[bucket] = f->id;
+}
+
+static void rebuild_buckets(void)
+{
+    memset(buckets.first_figure_id, 0, sizeof(buckets.first_figure_id));
+    for (int i = 1; i < figure_count(); i++) {
+        figure *f = figure_get(i);
+        f->bucket_id = 0;
+        f->next_figure_id_in_bucket = 0;
+        f->previous_figure_id_in_bucket = 0;
+    }
+    for (int grid_offset = 0; grid_offset < GRID_SIZE * GRID_SIZE; grid_offset++) {
+        int figure_id = figures.items[grid_offset];
+        while (figure_id) {
+            figure *f = figure_get(figure_id);
+            add_to_bucket(f);
+            figure_id = f->next_figure_id_on_same_tile;
+        }
+    }
+    buckets.needs_rebuild = 0;
+}
+
 int map_has_figure_at(int grid_offset)
 {
     return map_grid_is_valid_offset(grid_offset) && figures.items[grid_offset] > 0;
@@ -41,6 +110,9 @@ void map_figure_add(figure *f)
     } else {
         figures.items[f->grid_offset] = f->id;
     }
+    if (!buckets.needs_rebuild) {
+        add_to_bucket(f);
+    }
 }
 
 void map_figure_update(figure *f)
@@ -64,6 +136,9 @@ void map_figure_update(figure *f)
 
 void map_figure_delete(figure *f)
 {
+    if (!buckets.needs_rebuild) {
+        remove_from_bucket(f);
+    }
     if (!map_grid_is_valid_offset(f->grid_offset) || !figures.items[f->grid_offset]) {
         f->next_figure_id_on_same_tile = 0;
         return;
@@ -96,9 +171,44 @@ int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f))
     return 0;
 }
 
+int map_figure_foreach_in_area(int x, int y, int distance, void (*callback)(figure *f))
+{
+    if (buckets.needs_rebuild) {
+        rebuild_buckets();
+    }
+    int x_min = (x - distance) / BUCKET_SIZE;
+    int y_min = (y - distance) / BUCKET_SIZE;
+    int x_max = (x + distance) / BUCKET_SIZE;
+    int y_max = (y + distance) / BUCKET_SIZE;
+    if (x - distance < 0) {
+        x_min = 0;
+    }
+    if (y - distance < 0) {
+        y_min = 0;
+    }
+    if (x_max >= BUCKETS_PER_ROW) {
+        x_max = BUCKETS_PER_ROW - 1;
+    }
+    if (y_max >= BUCKETS_PER_ROW) {
+        y_max = BUCKETS_PER_ROW - 1;
+    }
+    for (int yy = y_min; yy <= y_max; yy++) {
+        for (int xx = x_min; xx <= x_max; xx++) {
+            int figure_id = buckets.first_figure_id[yy * BUCKETS_PER_ROW + xx];
+            while (figure_id) {
+                figure *f = figure_get(figure_id);
+                figure_id = f->next_figure_id_in_bucket;
+                callback(f);
+            }
+        }
+    }
+    return x_min == 0 && y_min == 0 && x_max == BUCKETS_PER_ROW - 1 && y_max == BUCKETS_PER_ROW - 1;
+}
+
 void map_figure_clear(void)
 {
     map_grid_clear_u16(figures.items);
+    buckets.needs_rebuild = 1;
 }
 
 void map_figure_save_state(buffer *buf)
@@ -109,4 +219,5 @@ void map_figure_save_state(buffer *buf)
 void map_figure_load_state(buffer *buf)
 {
     map_grid_load_state_u16(figures.items, buf);
+    buckets.needs_rebuild = 1;
 }
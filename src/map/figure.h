@@ -26,6 +26,18 @@ void map_figure_delete(figure *f);
 
 int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f));
 
+/**
+ * Calls the callback for every figure on the map near the given tile.
+ * Figures are visited per coarse bucket, so the callback also gets figures slightly
+ * outside the distance and must check the exact distance itself.
+ * @param x Tile x
+ * @param y Tile y
+ * @param distance Maximum distance from the tile
+ * @param callback Function to call for each figure
+ * @return True if the area covered the whole map
+ */
+int map_figure_foreach_in_area(int x, int y, int distance, void (*callback)(figure *f));
+
 /**
  * Clears the map
  */
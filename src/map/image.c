@@ -5,24 +5,53 @@
 #include "core/calc.h"
 #include "core/image.h"
 #include "core/image_group.h"
+#include "map/building.h"
 #include "map/building_tiles.h"
 #include "map/grid.h"
 #include "map/orientation.h"
 #include "map/tiles.h"
 
+#define MAX_ORIENTATIONS 4
+
 static grid_u32 images;
 static grid_u32 images_backup;
 
+// The terrain images of the other orientations are only valid while the terrain and buildings have not changed
+// since they were stored. Building images do not depend on the orientation, so their tiles keep the current image.
+static struct {
+    unsigned int map_version;
+    unsigned int rotated_version;
+    unsigned int rotation_start_version;
+    unsigned int stored_version[MAX_ORIENTATIONS];
+    int stored[MAX_ORIENTATIONS];
+    grid_u32 images[MAX_ORIENTATIONS];
+} orientations;
+
 unsigned int map_image_at(int grid_offset)
 {
     return images.items[grid_offset];
 }
 
 void map_image_set(int grid_offset, int image_id)
+{
+    if (images.items[grid_offset] != (unsigned int) image_id) {
+        images.items[grid_offset] = image_id;
+        if (!map_building_at(grid_offset)) {
+            orientations.map_version++;
+        }
+    }
+}
+
+void map_image_set_animation_frame(int grid_offset, int image_id)
 {
     images.items[grid_offset] = image_id;
 }
 
+void map_image_mark_changed(void)
+{
+    orientations.map_version++;
+}
+
 void map_image_backup(void)
 {
     map_grid_copy_u32(images.items, images_backup.items);
@@ -31,16 +60,53 @@ void map_image_backup(void)
 void map_image_restore(void)
 {
     map_grid_copy_u32(images_backup.items, images.items);
+    orientations.map_version++;
 }
 
 void map_image_restore_at(int grid_offset)
 {
-    images.items[grid_offset] = images_backup.items[grid_offset];
+    map_image_set(grid_offset, images_backup.items[grid_offset]);
 }
 
 void map_image_clear(void)
 {
     map_grid_clear_u32(images.items);
+    orientations.map_version++;
+}
+
+int map_image_begin_orientation_change(int old_orientation, int new_orientation)
+{
+    int old_index = old_orientation / 2;
+    int new_index = new_orientation / 2;
+    // Images updated while playing can differ from the ones a full update sets, so those are not stored
+    orientations.stored[old_index] = orientations.map_version == orientations.rotated_version;
+    if (orientations.stored[old_index]) {
+        map_grid_copy_u32(images.items, orientations.images[old_index].items);
+        orientations.stored_version[old_index] = orientations.map_version;
+    }
+    orientations.rotation_start_version = orientations.map_version;
+
+    if (!orientations.stored[new_index] || orientations.stored_version[new_index] != orientations.map_version) {
+        return 0;
+    }
+    const uint32_t *stored_images = orientations.images[new_index].items;
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        if (!map_building_at(i)) {
+            images.items[i] = stored_images[i];
+        }
+    }
+    return 1;
+}
+
+void map_image_end_orientation_change(void)
+{
+    // The rotation itself only updates the images for the new orientation, so the stored ones remain valid
+    for (int i = 0; i < MAX_ORIENTATIONS; i++) {
+        if (orientations.stored[i] && orientations.stored_version[i] == orientations.rotation_start_version) {
+            orientations.stored_version[i] = orientations.map_version;
+        }
+    }
+    orientations.rotated_version = orientations.map_version;
 }
 
 void map_image_init_edges(void)
@@ -56,6 +122,7 @@ void map_image_init_edges(void)
     images.items[map_grid_offset(0, height)] = 3;
     images.items[map_grid_offset(width, 0)] = 4;
     images.items[map_grid_offset(width, height)] = 5;
+    orientations.map_version++;
 }
 
 void map_image_update_all(void)
@@ -89,4 +156,5 @@ void map_image_save_state_legacy(buffer *buf)
 void map_image_load_state_legacy(buffer *buf)
 {
     map_grid_load_state_u16_to_u32(images.items, buf);
+    orientations.map_version++;
 }
@@ -7,6 +7,17 @@ unsigned int map_image_at(int grid_offset);
 
 void map_image_set(int grid_offset, int image_id);
 
+/**
+ * Sets the next frame of an animated terrain image, such as water.
+ * Unlike map_image_set, this keeps the images stored for the other orientations valid.
+ */
+void map_image_set_animation_frame(int grid_offset, int image_id);
+
+/**
+ * Marks the map as changed, so the images stored for the other orientations are no longer used
+ */
+void map_image_mark_changed(void);
+
 void map_image_backup(void);
 
 void map_image_restore(void);
@@ -17,6 +28,19 @@ void map_image_clear(void);
 void map_image_init_edges(void);
 void map_image_update_all(void);
 
+/**
+ * Stores the images of the old orientation and restores the ones of the new orientation
+ * @param old_orientation Orientation the map is rotated from
+ * @param new_orientation Orientation the map is rotated to
+ * @return 1 if the images of the new orientation were restored, 0 if they need to be updated
+ */
+int map_image_begin_orientation_change(int old_orientation, int new_orientation);
+
+/**
+ * Keeps the stored images valid after the images were updated for the new orientation
+ */
+void map_image_end_orientation_change(void);
+
 void map_image_save_state_legacy(buffer *buf);
 
 void map_image_load_state_legacy(buffer *buf);
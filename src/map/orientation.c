@@ -15,12 +15,14 @@
 #include "map/building_tiles.h"
 #include "map/data.h"
 #include "map/grid.h"
+#include "map/image.h"
 #include "map/natives.h"
 #include "map/property.h"
 #include "map/routing_terrain.h"
 #include "map/terrain.h"
 #include "map/tiles.h"
 #include "map/water.h"
+#include "map/water_supply.h"
 
 #include <math.h>
 #include <stdlib.h>
@@ -47,7 +49,7 @@ static void determine_leftmost_tile(void)
     }
 }
 
-void map_orientation_change(int counter_clockwise)
+static void update_terrain_images(void)
 {
     map_tiles_remove_entry_exit_flags();
     game_undo_disable();
@@ -69,17 +71,38 @@ void map_orientation_change(int counter_clockwise)
     map_tiles_update_all_plazas();
     map_tiles_update_all_walls();
     map_tiles_update_all_aqueducts(0);
-    building_connectable_update_connections();
+}
 
+void map_orientation_change(int counter_clockwise)
+{
+    int orientation = city_view_orientation();
+    int previous_orientation = (orientation + (counter_clockwise ? 2 : 6)) % 8;
+    // When rotating back to an orientation whose images are still valid, only the buildings need updating
+    if (map_image_begin_orientation_change(previous_orientation, orientation)) {
+        game_undo_disable();
+        determine_leftmost_tile();
+        // Walkers change the empty land grouping and desirability paves roads without changing the map version.
+        // Empty land includes meadow tiles, which the meadow pass then draws over.
+        map_tiles_update_all_empty_land();
+        map_tiles_update_all_meadow();
+        map_tiles_update_region_roads_except_aqueducts(0, 0, map_data.width - 1, map_data.height - 1);
+    } else {
+        update_terrain_images();
+    }
+    building_connectable_update_connections();
 
     map_orientation_update_buildings();
     map_bridge_update_after_rotate(counter_clockwise);
     map_routing_update_walls();
+    // Reservoir connections and highway aqueduct images depend on the orientation
+    map_water_supply_mark_aqueducts_changed();
 
     map_natives_check_land(0);
 
     figure_tower_sentry_reroute();
     figure_hippodrome_horse_reroute();
+
+    map_image_end_orientation_change();
 }
 
 int map_orientation_for_gatehouse(int x, int y)
@@ -14,6 +14,9 @@ static const int ADJACENT_OFFSETS[] = {-GRID_SIZE, 1, GRID_SIZE, -1};
 
 static grid_u8 network;
 
+// The networks are numbered in map order, so any change to the roads requires a full update
+static int network_changed = 1;
+
 static struct {
     int items[MAX_QUEUE];
     int head;
@@ -23,6 +26,12 @@ static struct {
 void map_road_network_clear(void)
 {
     map_grid_clear_u8(network.items);
+    network_changed = 1;
+}
+
+void map_road_network_mark_changed(void)
+{
+    network_changed = 1;
 }
 
 int map_road_network_get(int grid_offset)
@@ -79,6 +88,10 @@ static int mark_road_network(int grid_offset, uint8_t network_id)
 
 void map_road_network_update(void)
 {
+    if (!network_changed) {
+        return;
+    }
+    network_changed = 0;
     city_map_clear_largest_road_networks();
     map_grid_clear_u8(network.items);
     int network_id = 1;
@@ -3,6 +3,8 @@
 
 void map_road_network_clear(void);
 
+void map_road_network_mark_changed(void);
+
 int map_road_network_get(int grid_offset);
 
 void map_road_network_update(void);
@@ -1,6 +1,7 @@
 #include "routing.h"
 
 #include "building/building.h"
+#include "core/calc.h"
 #include "core/time.h"
 #include "map/building.h"
 #include "map/figure.h"
@@ -18,6 +19,10 @@
 #define UNTIL_STOP 0
 #define UNTIL_CONTINUE 1
 
+#define REGION_SIZE 8
+#define REGIONS_PER_ROW ((GRID_SIZE + REGION_SIZE - 1) / REGION_SIZE)
+#define SEARCH_AREA_BORDER 2
+
 typedef enum {
     DIRECTIONS_NO_DIAGONALS = 4,
     DIRECTIONS_DIAGONALS = 8
@@ -44,10 +49,27 @@ static struct {
     int enemy_routes_calculated;
 } stats;
 
+static struct {
+    int total_nodes_expanded;
+} profile;
+
+static struct {
+    unsigned int current;
+    unsigned int region[REGIONS_PER_ROW * REGIONS_PER_ROW];
+} generation;
+
+static struct {
+    int x_min;
+    int y_min;
+    int x_max;
+    int y_max;
+} search_area;
+
 static struct {
     int head;
     int tail;
     int items[MAX_QUEUE];
+    int16_t index_of[MAX_QUEUE]; // heap position per grid offset, only valid if items[] points back to it
 } queue;
 
 static grid_u8 water_drag;
@@ -108,34 +130,40 @@ static inline int ordered_queue_parent(int index)
     return (index - 1) / 2;
 }
 
-static inline void ordered_queue_swap(int first, int second)
+static inline void ordered_queue_set(int index, int offset)
 {
-    int temp = queue.items[first];
-    queue.items[first] = queue.items[second];
-    queue.items[second] = temp;
+    queue.items[index] = offset;
+    queue.index_of[offset] = index;
 }
 
 static void ordered_queue_reorder(int start_index)
 {
-    int left_child = 2 * start_index + 1;
-    if (left_child >= queue.tail) {
-        return;
-    }
-    int right_child = left_child + 1;
-    int smallest = start_index;
-    int16_t *offset_smallest = &distance.possible.items[queue.items[smallest]];
-    if (distance.possible.items[queue.items[left_child]] < *offset_smallest) {
-        smallest = left_child;
-        offset_smallest = &distance.possible.items[queue.items[smallest]];
-    }
-    if (right_child < queue.tail &&
-        distance.possible.items[queue.items[right_child]] < *offset_smallest) {
-        smallest = right_child;
-    }
-    if (smallest != start_index) {
-        ordered_queue_swap(start_index, smallest);
-        ordered_queue_reorder(smallest);
+    int offset = queue.items[start_index];
+    int16_t dist = distance.possible.items[offset];
+    int index = start_index;
+    while (1) {
+        int left_child = 2 * index + 1;
+        if (left_child >= queue.tail) {
+            break;
+        }
+        int right_child = left_child + 1;
+        int smallest = index;
+        int16_t dist_smallest = dist;
+        if (distance.possible.items[queue.items[left_child]] < dist_smallest) {
+            smallest = left_child;
+            dist_smallest = distance.possible.items[queue.items[smallest]];
+        }
+        if (right_child < queue.tail &&
+            distance.possible.items[queue.items[right_child]] < dist_smallest) {
+            smallest = right_child;
+        }
+        if (smallest == index) {
+            break;
+        }
+        ordered_queue_set(index, queue.items[smallest]);
+        index = smallest;
     }
+    ordered_queue_set(index, offset);
 }
 
 static inline int ordered_queue_pop(void)
@@ -148,11 +176,12 @@ static inline int ordered_queue_pop(void)
 
 static inline void ordered_queue_reduce_index(int index, int offset, int dist)
 {
-    queue.items[index] = offset;
     while (index && distance.possible.items[queue.items[ordered_queue_parent(index)]] > dist) {
-        ordered_queue_swap(index, ordered_queue_parent(index));
-        index = ordered_queue_parent(index);
+        int parent = ordered_queue_parent(index);
+        ordered_queue_set(index, queue.items[parent]);
+        index = parent;
     }
+    ordered_queue_set(index, offset);
 }
 
 static void ordered_enqueue(int next_offset, int current_dist, int remaining_dist)
@@ -163,11 +192,9 @@ static void ordered_enqueue(int next_offset, int current_dist, int remaining_dis
         if (distance.possible.items[next_offset] <= possible_dist) {
             return;
         } else {
-            for (int i = 0; i < queue.tail; i++) {
-                if (queue.items[i] == next_offset) {
-                    index = i;
-                    break;
-                }
+            int queued_index = queue.index_of[next_offset];
+            if (queued_index < queue.tail && queue.items[queued_index] == next_offset) {
+                index = queued_index;
             }
         }
     } else {
@@ -207,9 +234,26 @@ static void route_queue_from_to(int src_x, int src_y, int dst_x, int dst_y, int
     distance.dst_y = dst_y;
     int dest = map_grid_offset(dst_x, dst_y);
     ordered_enqueue(map_grid_offset(src_x, src_y), 1, 0);
+    search_area.x_min = search_area.y_min = GRID_SIZE;
+    search_area.x_max = search_area.y_max = 0;
     int tiles = 0;
     while (queue.tail) {
         int offset = ordered_queue_pop();
+        profile.total_nodes_expanded++;
+        int grid_x = offset % GRID_SIZE;
+        int grid_y = offset / GRID_SIZE;
+        if (grid_x < search_area.x_min) {
+            search_area.x_min = grid_x;
+        }
+        if (grid_x > search_area.x_max) {
+            search_area.x_max = grid_x;
+        }
+        if (grid_y < search_area.y_min) {
+            search_area.y_min = grid_y;
+        }
+        if (grid_y > search_area.y_max) {
+            search_area.y_max = grid_y;
+        }
         if (offset == dest || (max_tiles && ++tiles > max_tiles)) {
             break;
         }
@@ -242,6 +286,7 @@ static void route_queue_all_from(int source, max_directions directions,
             break;
         }
         int offset = queue_pop();
+        profile.total_nodes_expanded++;
         int drag = is_boat && terrain_water.items[offset] == WATER_N2_MAP_EDGE ? 4 : 0;
         if (water_drag.items[offset] < drag) {
             water_drag.items[offset]++;
@@ -671,6 +716,52 @@ void map_routing_block(int x, int y, int size)
     }
 }
 
+int map_routing_total_nodes_expanded(void)
+{
+    return profile.total_nodes_expanded;
+}
+
+void map_routing_get_search_area(map_routing_search_area *area)
+{
+    // tiles next to the expanded ones were checked during the search and next to those during path building
+    area->region_x_min = calc_bound(search_area.x_min - SEARCH_AREA_BORDER, 0, GRID_SIZE - 1) / REGION_SIZE;
+    area->region_y_min = calc_bound(search_area.y_min - SEARCH_AREA_BORDER, 0, GRID_SIZE - 1) / REGION_SIZE;
+    area->region_x_max = calc_bound(search_area.x_max + SEARCH_AREA_BORDER, 0, GRID_SIZE - 1) / REGION_SIZE;
+    area->region_y_max = calc_bound(search_area.y_max + SEARCH_AREA_BORDER, 0, GRID_SIZE - 1) / REGION_SIZE;
+    area->generation = generation.current;
+}
+
+int map_routing_search_area_changed(const map_routing_search_area *area)
+{
+    for (int y = area->region_y_min; y <= area->region_y_max; y++) {
+        for (int x = area->region_x_min; x <= area->region_x_max; x++) {
+            if (generation.region[y * REGIONS_PER_ROW + x] > area->generation) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+void map_routing_mark_tile_changed(int grid_offset)
+{
+    int region = (grid_offset / GRID_SIZE / REGION_SIZE) * REGIONS_PER_ROW + (grid_offset % GRID_SIZE) / REGION_SIZE;
+    generation.region[region] = ++generation.current;
+}
+
+void map_routing_mark_all_changed(void)
+{
+    ++generation.current;
+    for (int i = 0; i < REGIONS_PER_ROW * REGIONS_PER_ROW; i++) {
+        generation.region[i] = generation.current;
+    }
+}
+
+void map_routing_count_cached_route(void)
+{
+    ++stats.total_routes_calculated;
+}
+
 int map_routing_distance(int grid_offset)
 {
     return distance.determined.items[grid_offset];
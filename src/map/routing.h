@@ -19,6 +19,14 @@ typedef struct map_routing_distance_grid {
     int dst_y;
 } map_routing_distance_grid;
 
+typedef struct {
+    unsigned int generation;
+    uint8_t region_x_min;
+    uint8_t region_y_min;
+    uint8_t region_x_max;
+    uint8_t region_y_max;
+} map_routing_search_area;
+
 const map_routing_distance_grid *map_routing_get_distance_grid(void);
 
 void map_routing_calculate_distances(int x, int y);
@@ -31,6 +39,17 @@ void map_routing_delete_first_wall_or_aqueduct(int x, int y);
 
 int map_routing_distance(int grid_offset);
 
+int map_routing_total_nodes_expanded(void);
+
+void map_routing_get_search_area(map_routing_search_area *area);
+
+int map_routing_search_area_changed(const map_routing_search_area *area);
+
+void map_routing_mark_tile_changed(int grid_offset);
+void map_routing_mark_all_changed(void);
+
+void map_routing_count_cached_route(void);
+
 int map_routing_citizen_can_travel_over_land(int src_x, int src_y, int dst_x, int dst_y, int num_directions);
 int map_routing_citizen_can_travel_over_road_garden(int src_x, int src_y, int dst_x, int dst_y, int num_directions);
 int map_routing_citizen_can_travel_over_road_garden_highway(int src_x, int src_y, int dst_x, int dst_y, int num_directions);
@@ -9,10 +9,14 @@
 #include "map/image.h"
 #include "map/property.h"
 #include "map/random.h"
+#include "map/road_network.h"
+#include "map/routing.h"
 #include "map/routing_data.h"
 #include "map/sprite.h"
 #include "map/terrain.h"
 
+#include <string.h>
+
 static void map_routing_update_land_noncitizen(void);
 
 void map_routing_update_all(void)
@@ -99,8 +103,32 @@ static int get_land_type_citizen_aqueduct(int grid_offset)
     }
 }
 
+static int is_citizen_passable(int land_type)
+{
+    return land_type >= CITIZEN_0_ROAD && land_type <= CITIZEN_2_PASSABLE_TERRAIN;
+}
+
+static void mark_land_citizen_changes(const grid_i8 *previous)
+{
+    if (memcmp(previous->items, terrain_land_citizen.items, sizeof(previous->items)) == 0) {
+        return;
+    }
+    for (int grid_offset = 0; grid_offset < GRID_SIZE * GRID_SIZE; grid_offset++) {
+        if (previous->items[grid_offset] != terrain_land_citizen.items[grid_offset]) {
+            map_routing_mark_tile_changed(grid_offset);
+            // Road networks only spread over passable tiles
+            if (is_citizen_passable(previous->items[grid_offset]) ||
+                is_citizen_passable(terrain_land_citizen.items[grid_offset])) {
+                map_road_network_mark_changed();
+            }
+        }
+    }
+}
+
 void map_routing_update_land_citizen(void)
 {
+    static grid_i8 previous;
+    memcpy(previous.items, terrain_land_citizen.items, sizeof(previous.items));
     map_grid_init_i8(terrain_land_citizen.items, -1);
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
@@ -132,6 +160,7 @@ void map_routing_update_land_citizen(void)
             }
         }
     }
+    mark_land_citizen_changes(&previous);
 }
 
 static int get_land_type_noncitizen(int grid_offset)
@@ -3,8 +3,11 @@
 #include "city/map.h"
 #include "core/image.h"
 #include "map/grid.h"
+#include "map/image.h"
 #include "map/ring.h"
+#include "map/road_network.h"
 #include "map/routing.h"
+#include "map/water_supply.h"
 
 static grid_u32 terrain_grid;
 static grid_u32 terrain_grid_backup;
@@ -36,19 +39,42 @@ int map_terrain_get_from_buffer_32(buffer *buf, int grid_offset)
     return buffer_read_u32(buf);
 }
 
+static void check_terrain_change(int grid_offset, unsigned int old_terrain)
+{
+    unsigned int changed = old_terrain ^ terrain_grid.items[grid_offset];
+    if (changed & TERRAIN_HIGHWAY) {
+        map_routing_mark_tile_changed(grid_offset);
+    }
+    if (changed & (TERRAIN_ROAD | TERRAIN_ACCESS_RAMP)) {
+        map_road_network_mark_changed();
+    }
+    if (changed & (TERRAIN_AQUEDUCT | TERRAIN_HIGHWAY | TERRAIN_WATER)) {
+        map_water_supply_mark_aqueducts_changed();
+    }
+    if (changed & ~(TERRAIN_FOUNTAIN_RANGE | TERRAIN_RESERVOIR_RANGE)) {
+        map_image_mark_changed();
+    }
+}
+
 void map_terrain_set(int grid_offset, int terrain)
 {
+    unsigned int old_terrain = terrain_grid.items[grid_offset];
     terrain_grid.items[grid_offset] = terrain;
+    check_terrain_change(grid_offset, old_terrain);
 }
 
 void map_terrain_add(int grid_offset, int terrain)
 {
+    unsigned int old_terrain = terrain_grid.items[grid_offset];
     terrain_grid.items[grid_offset] |= terrain;
+    check_terrain_change(grid_offset, old_terrain);
 }
 
 void map_terrain_remove(int grid_offset, int terrain)
 {
+    unsigned int old_terrain = terrain_grid.items[grid_offset];
     terrain_grid.items[grid_offset] &= ~terrain;
+    check_terrain_change(grid_offset, old_terrain);
 }
 
 void map_terrain_add_with_radius(int x, int y, int size, int radius, int terrain)
@@ -78,6 +104,18 @@ void map_terrain_remove_with_radius(int x, int y, int size, int radius, int terr
 void map_terrain_remove_all(int terrain)
 {
     map_grid_and_u32(terrain_grid.items, ~terrain);
+    if (terrain & TERRAIN_HIGHWAY) {
+        map_routing_mark_all_changed();
+    }
+    if (terrain & (TERRAIN_ROAD | TERRAIN_ACCESS_RAMP)) {
+        map_road_network_mark_changed();
+    }
+    if (terrain & (TERRAIN_AQUEDUCT | TERRAIN_HIGHWAY | TERRAIN_WATER)) {
+        map_water_supply_mark_aqueducts_changed();
+    }
+    if (terrain & ~(TERRAIN_FOUNTAIN_RANGE | TERRAIN_RESERVOIR_RANGE)) {
+        map_image_mark_changed();
+    }
 }
 
 int map_terrain_count_directly_adjacent_with_type(int grid_offset, int terrain)
@@ -399,11 +437,19 @@ void map_terrain_backup(void)
 void map_terrain_restore(void)
 {
     map_grid_copy_u32(terrain_grid_backup.items, terrain_grid.items);
+    map_routing_mark_all_changed();
+    map_road_network_mark_changed();
+    map_water_supply_mark_aqueducts_changed();
+    map_image_mark_changed();
 }
 
 void map_terrain_clear(void)
 {
     map_grid_clear_u32(terrain_grid.items);
+    map_routing_mark_all_changed();
+    map_road_network_mark_changed();
+    map_water_supply_mark_aqueducts_changed();
+    map_image_mark_changed();
 }
 
 void map_terrain_init_outside_map(void)
@@ -420,6 +466,10 @@ void map_terrain_init_outside_map(void)
             }
         }
     }
+    map_routing_mark_all_changed();
+    map_road_network_mark_changed();
+    map_water_supply_mark_aqueducts_changed();
+    map_image_mark_changed();
 }
 
 void map_terrain_save_state(buffer *buf)
@@ -477,4 +527,8 @@ void map_terrain_load_state(buffer *buf, int expanded_terrain_data, buffer *imag
         map_grid_load_state_u16_to_u32(terrain_grid.items, buf);
     }
     determine_original_trees(images, legacy_image_buffer);
+    map_routing_mark_all_changed();
+    map_road_network_mark_changed();
+    map_water_supply_mark_aqueducts_changed();
+    map_image_mark_changed();
 }
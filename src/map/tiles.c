@@ -808,6 +808,18 @@ void map_tiles_update_area_roads(int x, int y, int size)
     foreach_region_tile(x - 1, y - 1, x + size - 2, y + size - 2, set_road_image);
 }
 
+static void set_road_image_except_aqueduct(int x, int y, int grid_offset)
+{
+    if (!map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
+        set_road_image(x, y, grid_offset);
+    }
+}
+
+void map_tiles_update_region_roads_except_aqueducts(int x_min, int y_min, int x_max, int y_max)
+{
+    foreach_region_tile(x_min, y_min, x_max, y_max, set_road_image_except_aqueduct);
+}
+
 int map_tiles_set_road(int x, int y)
 {
     int grid_offset = map_grid_offset(x, y);
@@ -836,6 +848,38 @@ void map_tiles_update_area_highways(int x, int y, int size)
     foreach_region_tile(x - 1, y - 1, x + size, y + size, set_highway_image);
 }
 
+static void set_highway_image_except_aqueduct(int x, int y, int grid_offset)
+{
+    if (!map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
+        set_highway_image(x, y, grid_offset);
+    }
+}
+
+void map_tiles_update_region_highways_except_aqueducts(int x_min, int y_min, int x_max, int y_max)
+{
+    foreach_region_tile(x_min, y_min, x_max, y_max, set_highway_image_except_aqueduct);
+}
+
+static void set_road_image_of_aqueduct(int x, int y, int grid_offset)
+{
+    if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
+        set_road_image(x, y, grid_offset);
+    }
+}
+
+static void set_highway_image_of_aqueduct(int x, int y, int grid_offset)
+{
+    if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
+        set_highway_image(x, y, grid_offset);
+    }
+}
+
+void map_tiles_update_all_road_aqueducts(void)
+{
+    foreach_map_tile(set_road_image_of_aqueduct);
+    foreach_map_tile(set_highway_image_of_aqueduct);
+}
+
 int map_tiles_set_highway(int x, int y)
 {
     int items = 0;
@@ -17,11 +17,14 @@ int map_tiles_set_wall(int x, int y);
 int map_tiles_is_paved_road(int grid_offset);
 void map_tiles_update_all_roads(void);
 void map_tiles_update_area_roads(int x, int y, int size);
+void map_tiles_update_region_roads_except_aqueducts(int x_min, int y_min, int x_max, int y_max);
 int map_tiles_set_road(int x, int y);
 
 int map_tiles_highway_get_aqueduct_image(int grid_offset);
 void map_tiles_update_all_highways(void);
 void map_tiles_update_area_highways(int x, int y, int size);
+void map_tiles_update_region_highways_except_aqueducts(int x_min, int y_min, int x_max, int y_max);
+void map_tiles_update_all_road_aqueducts(void);
 int map_tiles_set_highway(int x, int y);
 int map_tiles_clear_highway(int grid_offset, int measure_only);
 
@@ -18,6 +18,7 @@
 #include "map/tiles.h"
 #include "scenario/property.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #define OFFSET(x,y) (x + GRID_SIZE * y)
@@ -36,6 +37,16 @@ static struct {
     int tail;
 } queue;
 
+static struct {
+    int needs_update;
+    struct {
+        unsigned int *ids;
+        unsigned int count;
+        unsigned int size;
+    } reservoirs_in_use;
+    grid_u8 filled;
+} aqueducts = { 1 };
+
 static void mark_well_access(int well_id, int radius)
 {
     building *well = building_get(well_id);
@@ -79,20 +90,78 @@ void map_water_supply_update_buildings(void)
     }
 }
 
-static void set_all_aqueducts_to_no_water(void)
+void map_water_supply_mark_aqueducts_changed(void)
+{
+    aqueducts.needs_update = 1;
+}
+
+static int reservoirs_changed(void)
+{
+    int changed = 0;
+    unsigned int count = 0;
+    for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
+        if (b->state != BUILDING_STATE_IN_USE) {
+            continue;
+        }
+        if (count >= aqueducts.reservoirs_in_use.size) {
+            unsigned int new_size = aqueducts.reservoirs_in_use.size ? aqueducts.reservoirs_in_use.size * 2 : 16;
+            unsigned int *ids = realloc(aqueducts.reservoirs_in_use.ids, sizeof(unsigned int) * new_size);
+            if (!ids) {
+                // Without the list there is nothing to compare with, so let the water flow every time
+                aqueducts.reservoirs_in_use.count = 0;
+                return 1;
+            }
+            aqueducts.reservoirs_in_use.ids = ids;
+            aqueducts.reservoirs_in_use.size = new_size;
+        }
+        if (count >= aqueducts.reservoirs_in_use.count || aqueducts.reservoirs_in_use.ids[count] != b->id) {
+            aqueducts.reservoirs_in_use.ids[count] = b->id;
+            changed = 1;
+        }
+        count++;
+    }
+    if (count != aqueducts.reservoirs_in_use.count) {
+        aqueducts.reservoirs_in_use.count = count;
+        changed = 1;
+    }
+    return changed;
+}
+
+static int get_aqueduct_image(int grid_offset, int has_water)
+{
+    // Same image as drying the aqueduct first and then filling it again when it has water
+    int image_id = map_image_at(grid_offset);
+    int is_highway = map_terrain_is(grid_offset, TERRAIN_HIGHWAY);
+    if (has_water && is_highway) {
+        return map_tiles_highway_get_aqueduct_image(grid_offset);
+    }
+    int no_water_id = image_group(GROUP_BUILDING_AQUEDUCT_NO_WATER);
+    if (image_id < no_water_id) {
+        image_id += 15;
+    } else if (is_highway) {
+        return map_tiles_highway_get_aqueduct_image(grid_offset);
+    }
+    if (has_water && image_id >= no_water_id) {
+        image_id -= 15;
+    }
+    return image_id;
+}
+
+static void update_aqueduct_tiles(void)
 {
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
-            if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
-                map_aqueduct_set_water_access(grid_offset, 0);
-                int image_id = map_image_at(grid_offset);
-                if (image_id < image_group(GROUP_BUILDING_AQUEDUCT_NO_WATER)) {
-                    map_image_set(grid_offset, image_id + 15);
-                } else if(map_terrain_is(grid_offset, TERRAIN_HIGHWAY)) {
-                    image_id = map_tiles_highway_get_aqueduct_image(grid_offset);
-                    map_image_set(grid_offset, image_id);
-                }
+            if (!map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
+                continue;
+            }
+            int has_water = aqueducts.filled.items[grid_offset];
+            if (map_aqueduct_has_water_access_at(grid_offset) != has_water) {
+                map_aqueduct_set_water_access(grid_offset, has_water);
+            }
+            int image_id = get_aqueduct_image(grid_offset, has_water);
+            if (image_id != map_image_at(grid_offset)) {
+                map_image_set(grid_offset, image_id);
             }
         }
     }
@@ -123,14 +192,7 @@ static void fill_aqueducts_from_offset(int grid_offset)
         if (++guard >= GRID_SIZE * GRID_SIZE) {
             break;
         }
-        map_aqueduct_set_water_access(grid_offset, 1);
-        int image_id = map_image_at(grid_offset);
-        if (map_terrain_is(grid_offset, TERRAIN_HIGHWAY)) {
-            image_id = map_tiles_highway_get_aqueduct_image(grid_offset);
-            map_image_set(grid_offset, image_id);
-        } else if (image_id >= image_group(GROUP_BUILDING_AQUEDUCT_NO_WATER)) {
-            map_image_set(grid_offset, image_id - 15);
-        }
+        aqueducts.filled.items[grid_offset] = 1;
         next_offset = -1;
         for (int i = 0; i < 4; i++) {
             int new_offset = grid_offset + ADJACENT_OFFSETS[i];
@@ -140,7 +202,7 @@ static void fill_aqueducts_from_offset(int grid_offset)
                     b->has_water_access = 2;
                 }
             } else if (map_terrain_is(new_offset, TERRAIN_AQUEDUCT)) {
-                if (!map_aqueduct_has_water_access_at(new_offset)) {
+                if (!aqueducts.filled.items[new_offset]) {
                     if (next_offset == -1) {
                         next_offset = new_offset;
                     } else {
@@ -165,11 +227,9 @@ static void fill_aqueducts_from_offset(int grid_offset)
     } while (next_offset > -1);
 }
 
-void map_water_supply_update_reservoir_fountain(void)
+static void fill_aqueducts(void)
 {
-    map_terrain_remove_all(TERRAIN_FOUNTAIN_RANGE | TERRAIN_RESERVOIR_RANGE);
-    // reservoirs
-    set_all_aqueducts_to_no_water();
+    map_grid_clear_u8(aqueducts.filled.items);
     for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
         if (b->state != BUILDING_STATE_IN_USE) {
             continue;
@@ -197,6 +257,17 @@ void map_water_supply_update_reservoir_fountain(void)
             }
         }
     }
+    update_aqueduct_tiles();
+}
+
+void map_water_supply_update_reservoir_fountain(void)
+{
+    map_terrain_remove_all(TERRAIN_FOUNTAIN_RANGE | TERRAIN_RESERVOIR_RANGE);
+    // reservoirs: the water only needs to flow again when the aqueducts or reservoirs changed
+    if (reservoirs_changed() || aqueducts.needs_update) {
+        aqueducts.needs_update = 0;
+        fill_aqueducts();
+    }
     // mark reservoir ranges
     for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
         if (b->state == BUILDING_STATE_IN_USE && b->has_water_access) {
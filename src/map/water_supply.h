@@ -3,6 +3,7 @@
 
 void map_water_supply_update_buildings(void);
 void map_water_supply_update_reservoir_fountain(void);
+void map_water_supply_mark_aqueducts_changed(void);
 int map_water_supply_has_aqueduct_access(int grid_offset);
 
 enum {
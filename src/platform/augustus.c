@@ -7,6 +7,7 @@
 #include "core/log.h"
 #include "core/time.h"
 #include "game/game.h"
+#include "game/profiler.h"
 #include "game/settings.h"
 #include "game/system.h"
 #include "graphics/screen.h"
@@ -29,6 +30,7 @@
 #include "platform/switch/switch.h"
 #include "platform/touch.h"
 #include "platform/vita/vita.h"
+#include "widget/city_without_overlay.h"
 #include "window/asset_previewer.h"
 
 #include "tinyfiledialogs/tinyfiledialogs.h"
@@ -188,6 +190,68 @@ uint64_t system_get_ticks(void)
 #endif
 }
 
+static time_micros get_performance_micros(void)
+{
+    static Uint64 frequency;
+    if (!frequency) {
+        frequency = SDL_GetPerformanceFrequency();
+    }
+    Uint64 counter = SDL_GetPerformanceCounter();
+    return (counter / frequency) * 1000000 + (counter % frequency) * 1000000 / frequency;
+}
+
+int system_get_cpu_count(void)
+{
+    int count = SDL_GetCPUCount();
+    return count > 0 ? count : 1;
+}
+
+struct system_thread {
+    SDL_Thread *thread;
+    SDL_atomic_t finished;
+    int (*function)(void *data);
+    void *data;
+};
+
+static int run_thread(void *data)
+{
+    system_thread *thread = data;
+    int result = thread->function(thread->data);
+    SDL_AtomicSet(&thread->finished, 1);
+    return result;
+}
+
+system_thread *system_thread_start(int (*function)(void *data), void *data)
+{
+    system_thread *thread = malloc(sizeof(system_thread));
+    if (!thread) {
+        return 0;
+    }
+    SDL_AtomicSet(&thread->finished, 0);
+    thread->function = function;
+    thread->data = data;
+    thread->thread = SDL_CreateThread(run_thread, "augustus_worker", thread);
+    if (!thread->thread) {
+        SDL_Log("Unable to create thread: %s", SDL_GetError());
+        free(thread);
+        return 0;
+    }
+    return thread;
+}
+
+int system_thread_is_finished(system_thread *thread)
+{
+    return SDL_AtomicGet(&thread->finished);
+}
+
+int system_thread_wait(system_thread *thread)
+{
+    int result = 0;
+    SDL_WaitThread(thread->thread, &result);
+    free(thread);
+    return result;
+}
+
 #ifdef _WIN32
 #define PLATFORM_ENABLE_PER_FRAME_CALLBACK
 static void platform_per_frame_callback(void)
@@ -215,6 +279,9 @@ static void run_and_draw(void)
     if (config_get(CONFIG_UI_DISPLAY_FPS)) {
         game_display_fps(data.fps.last_fps);
     }
+    if (game_profiler_is_enabled()) {
+        game_display_profiler();
+    }
 
     platform_renderer_render();
 }
@@ -301,6 +368,8 @@ static void handle_event(SDL_Event *event)
         case SDL_RENDER_TARGETS_RESET:
 #endif
             platform_renderer_invalidate_target_textures();
+            // The saved terrain is in a target texture too, so its contents are gone
+            city_without_overlay_invalidate_terrain_cache();
             window_invalidate();
             break;
 #if SDL_VERSION_ATLEAST(2, 0, 4)
@@ -682,6 +751,7 @@ static void setup(const augustus_args *args)
     system_init_cursors(config_get(CONFIG_SCREEN_CURSOR_SCALE));
 
     time_set_millis(system_get_ticks());
+    time_set_micros_source(get_performance_micros);
 
     int result = args->launch_asset_previewer ? window_asset_previewer_show() : game_init();
 
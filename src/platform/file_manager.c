@@ -632,6 +632,11 @@ int platform_file_manager_remove_file(const char *filename)
     return android_remove_file(filename);
 }
 
+int platform_file_manager_rename_file(const char *src, const char *dst)
+{
+    return platform_file_manager_copy_file(src, dst) && android_remove_file(src);
+}
+
 #else
 
 FILE *platform_file_manager_open_file(const char *filename, const char *mode)
@@ -675,6 +680,33 @@ int platform_file_manager_remove_file(const char *filename)
     return result == 0;
 }
 
+int platform_file_manager_rename_file(const char *src, const char *dst)
+{
+#ifdef USE_FILE_CACHE
+    platform_file_manager_cache_delete_file_info(src);
+#endif
+    const file_name *wsrc = set_file_name(src);
+    const file_name *wdst = set_file_name(dst);
+#ifdef _WIN32
+    int result = MoveFileExW(wsrc, wdst, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    int result = rename(wsrc, wdst) == 0;
+#endif
+    free_file_name(wsrc);
+    free_file_name(wdst);
+#ifdef USE_FILE_CACHE
+    platform_file_manager_cache_update_file_info(dst);
+#endif
+#if defined(__EMSCRIPTEN__)
+    if (result) {
+        EM_ASM(
+            Module.syncFS();
+        );
+    }
+#endif
+    return result;
+}
+
 FILE *platform_file_manager_open_asset(const char *asset, const char *mode)
 {
     const char *cased_asset_path = dir_get_file_at_location(asset, PATH_LOCATION_ASSET);
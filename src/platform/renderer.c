@@ -35,10 +35,17 @@
 #define HAS_TEXTURE_SCALE_MODE 0
 #endif
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define USE_RENDER_GEOMETRY
+#define HAS_RENDER_GEOMETRY (platform_sdl_version_at_least(2, 0, 18))
+#endif
+
 #define MAX_UNPACKED_IMAGES 20
 
 #define MAX_PACKED_IMAGE_SIZE 64000
 
+#define MAX_BATCHED_SPRITES 2048
+
 #if (defined(__ANDROID__) || defined(__EMSCRIPTEN__)) && !SDL_VERSION_ATLEAST(2, 24, 0)
 // On the arm versions of android, on SDL < 2.24.0, atlas textures that are too large will make the renderer fetch
 // some images from the atlas with an off-by-one pixel, making things look terrible. Defining a smaller atlas texture
@@ -118,13 +125,123 @@ static struct {
     float city_scale;
     int should_correct_texture_offset;
     int disable_linear_filter;
+#ifdef USE_RENDER_GEOMETRY
+    struct {
+        int enabled;
+        int sprites;
+        SDL_Texture *texture;
+        float texture_width;
+        float texture_height;
+        SDL_Vertex vertices[MAX_BATCHED_SPRITES * 4];
+        int indices[MAX_BATCHED_SPRITES * 6];
+    } sprite_batch;
+#endif
 } data;
 
+static void flush_sprite_batch(void)
+{
+#ifdef USE_RENDER_GEOMETRY
+    if (!data.sprite_batch.sprites) {
+        return;
+    }
+    // The color of every sprite is already in its vertices
+    SDL_SetTextureColorMod(data.sprite_batch.texture, 0xff, 0xff, 0xff);
+    SDL_SetTextureAlphaMod(data.sprite_batch.texture, 0xff);
+    SDL_RenderGeometry(data.renderer, data.sprite_batch.texture,
+        data.sprite_batch.vertices, data.sprite_batch.sprites * 4,
+        data.sprite_batch.indices, data.sprite_batch.sprites * 6);
+    data.sprite_batch.sprites = 0;
+    data.sprite_batch.texture = 0;
+#endif
+}
+
+#ifdef USE_RENDER_GEOMETRY
+static void init_sprite_batch(void)
+{
+    data.sprite_batch.sprites = 0;
+    data.sprite_batch.texture = 0;
+    for (int i = 0; i < MAX_BATCHED_SPRITES; i++) {
+        int *indices = &data.sprite_batch.indices[i * 6];
+        int first_vertex = i * 4;
+        // Split along the top left to bottom right diagonal, which is the only order the software renderer
+        // recognizes as a rectangle and draws exactly like SDL_RenderCopy instead of as two triangles
+        indices[0] = first_vertex;
+        indices[1] = first_vertex + 1;
+        indices[2] = first_vertex + 3;
+        indices[3] = first_vertex;
+        indices[4] = first_vertex + 3;
+        indices[5] = first_vertex + 2;
+    }
+}
+
+static int can_batch_sprite(int texture_id, double angle)
+{
+    if (!data.sprite_batch.enabled || angle != 0.0) {
+        return 0;
+    }
+    // Custom images can be YUV or use other blend modes, so they are always drawn on their own
+    atlas_type type = texture_id >> IMAGE_ATLAS_BIT_OFFSET;
+    return type != ATLAS_CUSTOM && type != ATLAS_EXTERNAL;
+}
+
+static void add_sprite_to_batch(SDL_Texture *texture, const SDL_Rect *src, const SDL_FRect *dst, color_t color)
+{
+    if (texture != data.sprite_batch.texture || data.sprite_batch.sprites == MAX_BATCHED_SPRITES) {
+        flush_sprite_batch();
+    }
+    if (!data.sprite_batch.texture) {
+        int width, height;
+        if (SDL_QueryTexture(texture, NULL, NULL, &width, &height) != 0 || !width || !height) {
+            return;
+        }
+        data.sprite_batch.texture = texture;
+        data.sprite_batch.texture_width = (float) width;
+        data.sprite_batch.texture_height = (float) height;
+    }
+    if (!color) {
+        color = COLOR_MASK_NONE;
+    }
+    SDL_Color vertex_color = {
+        (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
+        (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
+        (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE,
+        (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA
+    };
+    float left = src->x / data.sprite_batch.texture_width;
+    float top = src->y / data.sprite_batch.texture_height;
+    float right = (src->x + src->w) / data.sprite_batch.texture_width;
+    float bottom = (src->y + src->h) / data.sprite_batch.texture_height;
+
+    SDL_Vertex *vertices = &data.sprite_batch.vertices[data.sprite_batch.sprites * 4];
+    vertices[0].position.x = dst->x;
+    vertices[0].position.y = dst->y;
+    vertices[0].tex_coord.x = left;
+    vertices[0].tex_coord.y = top;
+    vertices[1].position.x = dst->x + dst->w;
+    vertices[1].position.y = dst->y;
+    vertices[1].tex_coord.x = right;
+    vertices[1].tex_coord.y = top;
+    vertices[2].position.x = dst->x;
+    vertices[2].position.y = dst->y + dst->h;
+    vertices[2].tex_coord.x = left;
+    vertices[2].tex_coord.y = bottom;
+    vertices[3].position.x = dst->x + dst->w;
+    vertices[3].position.y = dst->y + dst->h;
+    vertices[3].tex_coord.x = right;
+    vertices[3].tex_coord.y = bottom;
+    for (int i = 0; i < 4; i++) {
+        vertices[i].color = vertex_color;
+    }
+    data.sprite_batch.sprites++;
+}
+#endif
+
 static int save_screen_buffer(color_t *pixels, int x, int y, int width, int height, int row_width)
 {
     if (data.paused) {
         return 0;
     }
+    flush_sprite_batch();
     SDL_Rect rect = { x, y, width, height };
     return SDL_RenderReadPixels(data.renderer, &rect, SDL_PIXELFORMAT_ARGB8888, pixels,
         row_width * sizeof(color_t)) == 0;
@@ -135,6 +252,7 @@ static void draw_line(int x_start, int x_end, int y_start, int y_end, color_t co
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetRenderDrawColor(data.renderer,
         (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
         (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
@@ -148,6 +266,7 @@ static void draw_rect(int x_start, int x_end, int y_start, int y_end, color_t co
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetRenderDrawColor(data.renderer,
         (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
         (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
@@ -162,6 +281,7 @@ static void fill_rect(int x_start, int x_end, int y_start, int y_end, color_t co
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetRenderDrawColor(data.renderer,
         (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
         (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
@@ -176,6 +296,7 @@ static void set_clip_rectangle(int x, int y, int width, int height)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_Rect clip = { x, y, width, height };
     SDL_RenderSetClipRect(data.renderer, &clip);
 }
@@ -185,6 +306,7 @@ static void reset_clip_rectangle(void)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_RenderSetClipRect(data.renderer, NULL);
 }
 
@@ -193,6 +315,7 @@ static void set_viewport(int x, int y, int width, int height)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_Rect viewport = { x, y, width, height };
     SDL_RenderSetViewport(data.renderer, &viewport);
 }
@@ -202,6 +325,7 @@ static void reset_viewport(void)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_RenderSetViewport(data.renderer, NULL);
     SDL_RenderSetClipRect(data.renderer, NULL);
 }
@@ -211,6 +335,7 @@ static void clear_screen(void)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetRenderDrawColor(data.renderer, 0, 0, 0, 0);
     SDL_RenderClear(data.renderer);
 }
@@ -235,6 +360,7 @@ static void free_silhouettes(void)
 
 static void free_unpacked_assets(void)
 {
+    flush_sprite_batch();
     for (int i = 0; i < MAX_UNPACKED_IMAGES; i++) {
         if (data.unpacked_images[i].texture) {
             SDL_DestroyTexture(data.unpacked_images[i].texture);
@@ -245,6 +371,7 @@ static void free_unpacked_assets(void)
 
 static void free_texture_atlas(atlas_type type)
 {
+    flush_sprite_batch();
     if (!data.texture_lists[type]) {
         return;
     }
@@ -416,6 +543,7 @@ static const image_atlas_data *get_texture_atlas(atlas_type type)
 
 static void free_all_textures(void)
 {
+    flush_sprite_batch();
     for (atlas_type i = ATLAS_FIRST; i < ATLAS_MAX - 1; i++) {
         free_texture_atlas_and_data(i);
     }
@@ -472,18 +600,8 @@ static SDL_Texture *get_texture(int texture_id)
     return data.texture_lists[type][texture_id & IMAGE_ATLAS_BIT_MASK];
 }
 
-static void set_texture_color_and_scale_mode(SDL_Texture *texture, color_t color, float scale)
+static void set_texture_scale_mode(SDL_Texture *texture, float scale)
 {
-    if (!color) {
-        color = COLOR_MASK_NONE;
-    }
-
-    SDL_SetTextureColorMod(texture,
-        (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
-        (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
-        (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE);
-    SDL_SetTextureAlphaMod(texture, (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA);
-
 #ifdef USE_TEXTURE_SCALE_MODE
     if (!HAS_TEXTURE_SCALE_MODE) {
         return;
@@ -498,11 +616,29 @@ static void set_texture_color_and_scale_mode(SDL_Texture *texture, color_t color
         desired_scale_mode = SDL_ScaleModeNearest;
     }
     if (current_scale_mode != desired_scale_mode) {
+        // Changing the scale mode binds the texture on some renderers, so the pending sprites have to be drawn
+        // first even when they use another texture
+        flush_sprite_batch();
         SDL_SetTextureScaleMode(texture, desired_scale_mode);
     }
 #endif
 }
 
+static void set_texture_color_and_scale_mode(SDL_Texture *texture, color_t color, float scale)
+{
+    if (!color) {
+        color = COLOR_MASK_NONE;
+    }
+
+    SDL_SetTextureColorMod(texture,
+        (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
+        (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
+        (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE);
+    SDL_SetTextureAlphaMod(texture, (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA);
+
+    set_texture_scale_mode(texture, scale);
+}
+
 static void draw_texture_advanced(const image *img, float x, float y, color_t color,
     float scale_x, float scale_y, double angle, int disable_coord_scaling)
 {
@@ -518,7 +654,17 @@ static void draw_texture_advanced(const image *img, float x, float y, color_t co
 
     float scale = scale_x == scale_y ? scale_x : 0.0f;
 
-    set_texture_color_and_scale_mode(texture, color, scale);
+#ifdef USE_RENDER_GEOMETRY
+    int batch_sprite = can_batch_sprite(img->atlas.id, angle);
+#else
+    int batch_sprite = 0;
+#endif
+    if (batch_sprite) {
+        set_texture_scale_mode(texture, scale);
+    } else {
+        flush_sprite_batch();
+        set_texture_color_and_scale_mode(texture, color, scale);
+    }
 
     x += img->x_offset;
     y += img->y_offset;
@@ -544,6 +690,12 @@ static void draw_texture_advanced(const image *img, float x, float y, color_t co
             (img->width - grid_correction) / scale_x,
             (img->height - grid_correction) / scale_y
         };
+#ifdef USE_RENDER_GEOMETRY
+        if (batch_sprite) {
+            add_sprite_to_batch(texture, &src_coords, &dst_coords, color);
+            return;
+        }
+#endif
         SDL_RenderCopyExF(data.renderer, texture, &src_coords, &dst_coords, angle, NULL, SDL_FLIP_NONE);
         return;
     }
@@ -568,6 +720,7 @@ static void create_custom_texture(custom_image_type type, int width, int height,
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     if (data.custom_textures[type].texture) {
         SDL_DestroyTexture(data.custom_textures[type].texture);
         data.custom_textures[type].texture = 0;
@@ -594,6 +747,7 @@ static color_t *get_custom_texture_buffer(custom_image_type type, int *actual_te
     if (data.paused || !data.custom_textures[type].texture) {
         return 0;
     }
+    flush_sprite_batch();
 
 #ifdef __vita__
     int pitch;
@@ -633,6 +787,7 @@ static void update_custom_texture(custom_image_type type)
     if (data.paused || !data.custom_textures[type].texture || !data.custom_textures[type].buffer) {
         return;
     }
+    flush_sprite_batch();
     int width;
     SDL_QueryTexture(data.custom_textures[type].texture, NULL, NULL, &width, NULL);
     SDL_UpdateTexture(data.custom_textures[type].texture, NULL,
@@ -646,6 +801,7 @@ static void update_custom_texture_from(custom_image_type type, const color_t *bu
     if (data.paused || !data.custom_textures[type].texture) {
         return;
     }
+    flush_sprite_batch();
     int texture_width, texture_height;
     SDL_QueryTexture(data.custom_textures[type].texture, NULL, NULL, &texture_width, &texture_height);
     if (x_offset + width > texture_width || y_offset + height > texture_height) {
@@ -674,6 +830,7 @@ static void update_custom_texture_yuv(custom_image_type type, const uint8_t *y_d
     if (data.paused || !data.supports_yuv_textures || !data.custom_textures[type].texture) {
         return;
     }
+    flush_sprite_batch();
     int width, height;
     Uint32 format;
     SDL_QueryTexture(data.custom_textures[type].texture, &format, NULL, &width, &height);
@@ -691,6 +848,7 @@ static int start_tooltip_creation(int width, int height)
     if (data.paused) {
         return 0;
     }
+    flush_sprite_batch();
     if (data.tooltip.texture) {
         if (data.tooltip.texture_width < width || data.tooltip.texture_height < height) {
             SDL_DestroyTexture(data.tooltip.texture);
@@ -728,6 +886,7 @@ static void finish_tooltip_creation(void)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
     SDL_SetRenderTarget(data.renderer, data.render_texture);
 }
@@ -766,6 +925,7 @@ static int save_to_texture(int texture_id, int x, int y, int width, int height)
     if (data.paused) {
         return 0;
     }
+    flush_sprite_batch();
     SDL_Texture *former_target = SDL_GetRenderTarget(data.renderer);
     if (!former_target) {
         return 0;
@@ -841,6 +1001,7 @@ static void draw_saved_texture(int texture_id, int x, int y)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     buffer_texture *texture_info = get_saved_texture_info(texture_id);
     if (!texture_info) {
         return;
@@ -852,6 +1013,7 @@ static void draw_saved_texture(int texture_id, int x, int y)
 
 static void create_blend_texture(custom_image_type type)
 {
+    flush_sprite_batch();
     SDL_Texture *texture = SDL_CreateTexture(data.renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_TARGET, 58, 30);
     if (!texture) {
         return;
@@ -900,6 +1062,7 @@ static SDL_Texture *get_silhouette_texture(const image *img)
     if (data.paused) {
         return 0;
     }
+    flush_sprite_batch();
     silhouette_texture *last_silhouette = 0;
 
     for (silhouette_texture *silhouette = data.silhouettes; silhouette; silhouette = silhouette->next) {
@@ -1047,6 +1210,7 @@ static void load_unpacked_image(const image *img, const color_t *pixels)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     int first_empty = -1;
     int oldest_texture_index = 0;
     int unpacked_image_id = img->atlas.id & IMAGE_ATLAS_BIT_MASK;
@@ -1107,6 +1271,7 @@ static void load_unpacked_image(const image *img, const color_t *pixels)
 
 static void free_unpacked_image(const image *img)
 {
+    flush_sprite_batch();
     int unpacked_image_id = img->atlas.id & IMAGE_ATLAS_BIT_MASK;
     int found_id = -1;
     for (int i = 0; i < MAX_UNPACKED_IMAGES; i++) {
@@ -1244,11 +1409,37 @@ int platform_renderer_init(SDL_Window *window)
 
     SDL_SetRenderDrawColor(data.renderer, 0, 0, 0, 0xff);
 
+#ifdef USE_RENDER_GEOMETRY
+    init_sprite_batch();
+#endif
+    // Off unless screen_batch_sprites=1 is set in augustus.ini, the default stays one SDL_RenderCopyExF call per image
+    platform_renderer_set_sprite_batching(config_get(CONFIG_SCREEN_BATCH_SPRITES));
+
     create_renderer_interface();
 
     return 1;
 }
 
+void platform_renderer_set_sprite_batching(int enabled)
+{
+    flush_sprite_batch();
+#ifdef USE_RENDER_GEOMETRY
+    // Batched sprites are positioned with floats, so the SDL_RenderCopyExF path must be there to match them.
+    // The software renderer turns every quad back into its own copy and rounds its size differently, so
+    // batching there is slower than drawing each sprite and does not match it.
+    data.sprite_batch.enabled = enabled && !data.is_software_renderer && HAS_RENDER_GEOMETRY && HAS_RENDERCOPYF;
+#endif
+}
+
+int platform_renderer_is_sprite_batching(void)
+{
+#ifdef USE_RENDER_GEOMETRY
+    return data.sprite_batch.enabled;
+#else
+    return 0;
+#endif
+}
+
 static void destroy_render_texture(void)
 {
     if (data.render_texture) {
@@ -1266,6 +1457,7 @@ int platform_renderer_create_render_texture(int width, int height)
     if (data.paused) {
         return 1;
     }
+    flush_sprite_batch();
     destroy_render_texture();
 
 #ifdef USE_TEXTURE_SCALE_MODE
@@ -1323,6 +1515,7 @@ int platform_renderer_lost_render_texture(void)
 
 void platform_renderer_invalidate_target_textures(void)
 {
+    flush_sprite_batch();
     if (data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture) {
         SDL_DestroyTexture(data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture);
         data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture = 0;
@@ -1392,6 +1585,7 @@ void platform_renderer_render(void)
     if (data.paused) {
         return;
     }
+    flush_sprite_batch();
     SDL_SetRenderTarget(data.renderer, NULL);
     SDL_RenderCopy(data.renderer, data.render_texture, NULL, NULL);
     draw_tooltip();
@@ -1427,6 +1621,7 @@ void platform_renderer_generate_mouse_cursor_texture(int cursor_id, int size, co
 
 void platform_renderer_pause(void)
 {
+    flush_sprite_batch();
     SDL_SetRenderTarget(data.renderer, NULL);
     data.paused = 1;
 }
@@ -1440,6 +1635,10 @@ void platform_renderer_resume(void)
 
 void platform_renderer_destroy(void)
 {
+#ifdef USE_RENDER_GEOMETRY
+    data.sprite_batch.sprites = 0;
+    data.sprite_batch.texture = 0;
+#endif
     destroy_render_texture();
     if (data.renderer) {
         SDL_DestroyRenderer(data.renderer);
@@ -13,6 +13,14 @@ int platform_renderer_lost_render_texture(void);
 
 void platform_renderer_invalidate_target_textures(void);
 
+/**
+ * Draws consecutive atlas images from the same texture with one SDL_RenderGeometry call.
+ * Needs SDL 2.0.18 or later, otherwise batching stays off.
+ */
+void platform_renderer_set_sprite_batching(int enabled);
+
+int platform_renderer_is_sprite_batching(void);
+
 void platform_renderer_generate_mouse_cursor_texture(int cursor_id, int size, const color_t *pixels,
     int hotspot_x, int hotspot_y);
 
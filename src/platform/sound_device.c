@@ -13,6 +13,7 @@
 #include "SDL.h"
 #include "SDL_mixer.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -27,6 +28,10 @@
 
 #define NO_CHANNEL -1
 
+// Always larger than the number of channels, so there is an unused entry to evict
+#define MAX_CACHED_CHUNKS 128
+#define MAX_CACHED_CHUNK_BYTES (16 * 1024 * 1024)
+
 #if SDL_VERSION_ATLEAST(2, 0, 7)
 #define USE_SDL_AUDIOSTREAM
 #endif
@@ -41,8 +46,15 @@ static struct {
 #endif
 
 typedef struct {
-    const char *filename;
+    char key[FILE_NAME_MAX];
     Mix_Chunk *chunk;
+    int references;
+    unsigned int last_used;
+} cached_chunk;
+
+typedef struct {
+    const char *filename;
+    cached_chunk *chunk;
     time_millis last_played;
 } sound_channel;
 
@@ -78,6 +90,12 @@ static struct {
     int cur_write;
 } custom_music;
 
+static struct {
+    cached_chunk entries[MAX_CACHED_CHUNKS];
+    unsigned int use_counter;
+    sound_device_chunk_cache_stats stats;
+} chunk_cache;
+
 static int percentage_to_volume(int percentage)
 {
     int master_percentage = config_get(CONFIG_GENERAL_MASTER_VOLUME);
@@ -157,13 +175,32 @@ static void stop_channel(int channel)
     sound_channel *ch = &data.channels[channel];
     if (ch->chunk) {
         Mix_HaltChannel(channel);
-        Mix_FreeChunk(ch->chunk);
+        ch->chunk->references--;
         ch->chunk = 0;
     }
     ch->filename = 0;
     ch->last_played = 0;
 }
 
+static void free_cached_chunk(cached_chunk *entry)
+{
+    chunk_cache.stats.bytes -= entry->chunk->alen;
+    chunk_cache.stats.chunks--;
+    Mix_FreeChunk(entry->chunk);
+    entry->chunk = 0;
+    entry->key[0] = 0;
+    entry->references = 0;
+}
+
+static void clear_chunk_cache(void)
+{
+    for (int i = 0; i < MAX_CACHED_CHUNKS; i++) {
+        if (chunk_cache.entries[i].chunk) {
+            free_cached_chunk(&chunk_cache.entries[i]);
+        }
+    }
+}
+
 void sound_device_close(void)
 {
     if (!data.initialized) {
@@ -173,6 +210,7 @@ void sound_device_close(void)
         stop_channel(i);
     }
     Mix_ChannelFinished(NULL);
+    clear_chunk_cache();
     Mix_CloseAudio();
     free(data.channels);
     data.channels = 0;
@@ -207,6 +245,79 @@ static Mix_Chunk *load_chunk(const char *filename)
 #endif
 }
 
+static void get_chunk_key(const char *filename, char *key)
+{
+    // Campaign files take precedence over the game files, which may come from the language directory
+    if (game_campaign_has_file(filename)) {
+        snprintf(key, FILE_NAME_MAX, "campaign:%s:%s", game_campaign_get_name(), filename);
+    } else {
+        snprintf(key, FILE_NAME_MAX, "file:%s:%s", config_get_string(CONFIG_STRING_UI_LANGUAGE_DIR), filename);
+    }
+}
+
+static cached_chunk *get_free_cache_entry(size_t new_bytes)
+{
+    cached_chunk *free_entry = 0;
+    while (1) {
+        cached_chunk *least_recently_used = 0;
+        for (int i = 0; i < MAX_CACHED_CHUNKS; i++) {
+            cached_chunk *entry = &chunk_cache.entries[i];
+            if (!entry->chunk) {
+                free_entry = entry;
+            } else if (!entry->references &&
+                (!least_recently_used || entry->last_used < least_recently_used->last_used)) {
+                least_recently_used = entry;
+            }
+        }
+        if (!least_recently_used ||
+            (free_entry && chunk_cache.stats.bytes + new_bytes <= MAX_CACHED_CHUNK_BYTES)) {
+            return free_entry;
+        }
+        free_cached_chunk(least_recently_used);
+        chunk_cache.stats.evictions++;
+    }
+}
+
+static cached_chunk *acquire_chunk(const char *filename)
+{
+    if (!filename || !*filename) {
+        return 0;
+    }
+    char key[FILE_NAME_MAX];
+    get_chunk_key(filename, key);
+    for (int i = 0; i < MAX_CACHED_CHUNKS; i++) {
+        cached_chunk *entry = &chunk_cache.entries[i];
+        if (entry->chunk && strcmp(entry->key, key) == 0) {
+            entry->references++;
+            entry->last_used = ++chunk_cache.use_counter;
+            chunk_cache.stats.hits++;
+            return entry;
+        }
+    }
+    chunk_cache.stats.misses++;
+    Mix_Chunk *chunk = load_chunk(filename);
+    if (!chunk) {
+        return 0;
+    }
+    cached_chunk *entry = get_free_cache_entry(chunk->alen);
+    if (!entry) {
+        Mix_FreeChunk(chunk);
+        return 0;
+    }
+    snprintf(entry->key, FILE_NAME_MAX, "%s", key);
+    entry->chunk = chunk;
+    entry->references = 1;
+    entry->last_used = ++chunk_cache.use_counter;
+    chunk_cache.stats.bytes += chunk->alen;
+    chunk_cache.stats.chunks++;
+    return entry;
+}
+
+void sound_device_get_chunk_cache_stats(sound_device_chunk_cache_stats *stats)
+{
+    *stats = chunk_cache.stats;
+}
+
 static void callback_for_audio_finished(int channel)
 {
     if (!data.sound_finished_callback) {
@@ -230,9 +341,7 @@ void sound_device_init_channels(void)
     Mix_AllocateChannels(data.total_channels);
     log_info("Loading audio files", 0, 0);
     for (int i = 0; i < data.total_channels; i++) {
-        data.channels[i].chunk = 0;
-        data.channels[i].filename = 0;
-        data.channels[i].last_played = 0;
+        stop_channel(i);
     }
     Mix_ChannelFinished(callback_for_audio_finished);
 }
@@ -270,7 +379,7 @@ void sound_device_set_volume_for_type(sound_type type, int volume_pct)
     for (int i = 0; i < sound_type_to_channels[type].total; i++) {
         int channel = i + sound_type_to_channels[type].start;
         if (data.channels[channel].chunk) {
-            Mix_VolumeChunk(data.channels[channel].chunk, percentage_to_volume(volume_pct));
+            Mix_Volume(channel, percentage_to_volume(volume_pct));
         }
     }
 }
@@ -381,15 +490,16 @@ int sound_device_play_file_on_channel_panned(const char *filename, sound_type ty
             return 0;
         }
         stop_channel(channel);
-        data.channels[channel].chunk = load_chunk(filename);
+        data.channels[channel].chunk = acquire_chunk(filename);
         if (!data.channels[channel].chunk) {
             return 0;
         }
         data.channels[channel].filename = filename;
     }
     Mix_SetPanning(channel, left_pct * 255 / 100, right_pct * 255 / 100);
-    Mix_VolumeChunk(data.channels[channel].chunk, percentage_to_volume(volume_pct));
-    int result = Mix_PlayChannel(channel, data.channels[channel].chunk, 0);
+    // Chunks are shared between channels, so the volume is set on the channel
+    Mix_Volume(channel, percentage_to_volume(volume_pct));
+    int result = Mix_PlayChannel(channel, data.channels[channel].chunk->chunk, 0);
     if (result == -1) {
         return 0;
     }
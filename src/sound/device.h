@@ -1,6 +1,8 @@
 #ifndef SOUND_DEVICE_H
 #define SOUND_DEVICE_H
 
+#include <stddef.h>
+
 typedef enum {
     SOUND_TYPE_MIN = 0,
     SOUND_TYPE_SPEECH = 0,
@@ -29,6 +31,20 @@ void sound_device_stop_type(sound_type type);
 void sound_device_on_audio_finished(void (*callback)(sound_type));
 void sound_device_fadeout_music(int milisseconds);
 
+typedef struct {
+    int hits;
+    int misses;
+    int evictions;
+    int chunks;
+    size_t bytes;
+} sound_device_chunk_cache_stats;
+
+/**
+ * Gets the statistics of the decoded sound cache, shared by all channels
+ * @param stats Statistics to fill
+ */
+void sound_device_get_chunk_cache_stats(sound_device_chunk_cache_stats *stats);
+
 /**
  * Use a custom music player, for external music data (e.g. videos)
  * @param bitdepth Bitdepth, either 8 or 16
@@ -1590,7 +1590,12 @@ static translation_string all_strings[] = {
     {TR_SELECTED, "Selected"},
     {TR_WINDOW_MESSAGE_LIST_SELECTED_ALL, "All messages"},
     {TR_WINDOW_MESSAGE_LIST_SELECTED_COMMON, "Common messages" },
-    {TR_WINDOW_MESSAGE_LIST_SELECTED_CUSTOM, "Custom messages" }
+    {TR_WINDOW_MESSAGE_LIST_SELECTED_CUSTOM, "Custom messages" },
+    {TR_CHEAT_ROUTE_CACHE_HITS, "Route cache hits"},
+    {TR_CHEAT_ROUTE_CACHE_MISSES, "misses"},
+    {TR_CHEAT_PROFILER_ENABLED, "Profiler enabled"},
+    {TR_CHEAT_PROFILER_DISABLED, "Profiler disabled"},
+    {TR_CHEAT_PROFILER_DUMPED, "Profiler results written to the log"}
 };
 
 void translation_english(const translation_string **strings, int *num_strings)
@@ -1583,6 +1583,11 @@ typedef enum {
     TR_WINDOW_MESSAGE_LIST_SELECTED_ALL,
     TR_WINDOW_MESSAGE_LIST_SELECTED_COMMON,
     TR_WINDOW_MESSAGE_LIST_SELECTED_CUSTOM,
+    TR_CHEAT_ROUTE_CACHE_HITS,
+    TR_CHEAT_ROUTE_CACHE_MISSES,
+    TR_CHEAT_PROFILER_ENABLED,
+    TR_CHEAT_PROFILER_DISABLED,
+    TR_CHEAT_PROFILER_DUMPED,
     TRANSLATION_MAX_KEY
 } translation_key;
 
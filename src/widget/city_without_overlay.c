@@ -46,6 +46,8 @@
 #include "widget/city_figure.h"
 #include "widget/city_draw_highway.h"
 
+#include <string.h>
+
 #define OFFSET(x,y) (x + GRID_SIZE * y)
 
 #define WAREHOUSE_FLAG_FRAMES 9
@@ -78,6 +80,36 @@ static struct {
     float scale;
 } draw_context;
 
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+    int camera_x;
+    int camera_y;
+    int orientation;
+    int scale;
+    int show_grid;
+} terrain_view;
+
+typedef struct {
+    int image_id;
+    color_t color_mask;
+} cached_footprint;
+
+// Plain footprints of the last drawn viewport, kept in a saved screen image so that only changed tiles are redrawn.
+// Highways, animated water and the translucent grid and roamer overlays are never saved in it.
+static struct {
+    int is_valid;
+    int image_id;
+    terrain_view view;
+    terrain_view last_frame_view;
+    int is_restored;
+    int should_save;
+    int has_changed_tiles;
+    cached_footprint tiles[GRID_SIZE * GRID_SIZE];
+} terrain_cache;
+
 static void init_draw_context(int selected_figure_id, pixel_coordinate *figure_coord, int highlighted_formation)
 {
     draw_context.advance_water_animation = 0;
@@ -96,6 +128,60 @@ static void init_draw_context(int selected_figure_id, pixel_coordinate *figure_c
     draw_context.scale = city_view_get_scale() / 100.0f;
 }
 
+static int restore_terrain_cache(int x, int y, int width, int height)
+{
+    terrain_view view;
+    view.x = x;
+    view.y = y;
+    view.width = width;
+    view.height = height;
+    city_view_get_camera_in_pixels(&view.camera_x, &view.camera_y);
+    view.orientation = city_view_orientation();
+    view.scale = city_view_get_scale();
+    view.show_grid = config_get(CONFIG_UI_SHOW_GRID);
+
+    terrain_cache.has_changed_tiles = 0;
+    terrain_cache.is_restored = terrain_cache.is_valid &&
+        memcmp(&terrain_cache.view, &view, sizeof(terrain_view)) == 0;
+    // While scrolling or zooming every frame shows a new view, so saving it would only cost a screen read
+    terrain_cache.should_save = terrain_cache.is_restored ||
+        memcmp(&terrain_cache.last_frame_view, &view, sizeof(terrain_view)) == 0;
+    terrain_cache.last_frame_view = view;
+    if (terrain_cache.is_restored) {
+        graphics_draw_from_image(terrain_cache.image_id, x, y);
+        return 1;
+    }
+    terrain_cache.view = view;
+    return 0;
+}
+
+static void save_terrain_cache(void)
+{
+    if (!terrain_cache.should_save || (terrain_cache.is_restored && !terrain_cache.has_changed_tiles)) {
+        return;
+    }
+    terrain_cache.image_id = graphics_save_to_image(terrain_cache.image_id,
+        terrain_cache.view.x, terrain_cache.view.y, terrain_cache.view.width, terrain_cache.view.height);
+    terrain_cache.is_valid = terrain_cache.image_id != 0;
+}
+
+static int footprint_needs_drawing(int grid_offset, int image_id, color_t color_mask)
+{
+    cached_footprint *tile = &terrain_cache.tiles[grid_offset];
+    if (terrain_cache.is_restored && tile->image_id == image_id && tile->color_mask == color_mask) {
+        return 0;
+    }
+    tile->image_id = image_id;
+    tile->color_mask = color_mask;
+    terrain_cache.has_changed_tiles = 1;
+    return 1;
+}
+
+void city_without_overlay_invalidate_terrain_cache(void)
+{
+    terrain_cache.is_valid = 0;
+}
+
 static int draw_building_as_deleted(building *b)
 {
     b = building_main(b);
@@ -140,11 +226,34 @@ static void draw_roamer_frequency(int x, int y, int grid_offset)
     }
 }
 
+static int is_animated_water(int image_id)
+{
+    return image_id >= draw_context.image_id_water_first && image_id <= draw_context.image_id_water_last;
+}
+
+static int is_highway(int grid_offset)
+{
+    return map_terrain_is(grid_offset, TERRAIN_HIGHWAY) && !map_terrain_is(grid_offset, TERRAIN_GATEHOUSE);
+}
+
+static int footprint_image_id(int grid_offset)
+{
+    if (map_property_is_constructing(grid_offset)) { //&&
+        //  !building_is_connectable(building_construction_type())) {
+        return image_group(GROUP_TERRAIN_OVERLAY);
+    }
+    return map_image_at(grid_offset);
+}
+
 static void draw_footprint(int x, int y, int grid_offset)
 {
     sound_city_progress_ambient();
     building_construction_record_view_position(x, y, grid_offset);
-    if (grid_offset < 0 || !map_property_is_draw_tile(grid_offset)) {
+    if (grid_offset < 0) {
+        return;
+    }
+    if (!map_property_is_draw_tile(grid_offset)) {
+        footprint_needs_drawing(grid_offset, 0, 0);
         return;
     }
     // Valid grid_offset and leftmost tile -> draw
@@ -177,26 +286,36 @@ static void draw_footprint(int x, int y, int grid_offset)
     if (map_terrain_is(grid_offset, TERRAIN_GARDEN)) {
         sound_city_mark_building_view(BUILDING_GARDENS, 0, SOUND_DIRECTION_CENTER);
     }
-    int image_id = map_image_at(grid_offset);
-    if (map_property_is_constructing(grid_offset)) { //&&
-        //  !building_is_connectable(building_construction_type())) {
-        image_id = image_group(GROUP_TERRAIN_OVERLAY);
+    int image_id = footprint_image_id(grid_offset);
+    // Highways and animated water are drawn every frame by draw_uncached_footprint
+    if (is_highway(grid_offset) || is_animated_water(image_id)) {
+        footprint_needs_drawing(grid_offset, 0, 0);
+        return;
     }
-    if (draw_context.advance_water_animation &&
-        image_id >= draw_context.image_id_water_first &&
-        image_id <= draw_context.image_id_water_last) {
-        image_id++;
-        if (image_id > draw_context.image_id_water_last) {
-            image_id = draw_context.image_id_water_first;
-        }
-        map_image_set(grid_offset, image_id);
+    if (footprint_needs_drawing(grid_offset, image_id, color_mask)) {
+        image_draw_isometric_footprint_from_draw_tile(image_id, x, y, color_mask, draw_context.scale);
+    }
+}
+
+static void draw_uncached_footprint(int x, int y, int grid_offset)
+{
+    if (grid_offset < 0 || !map_property_is_draw_tile(grid_offset)) {
+        return;
     }
-    if (map_terrain_is(grid_offset, TERRAIN_HIGHWAY) && !map_terrain_is(grid_offset, TERRAIN_GATEHOUSE)) {
+    int image_id = footprint_image_id(grid_offset);
+    if (is_highway(grid_offset)) {
         city_draw_highway_footprint(x, y, draw_context.scale, grid_offset);
-    } else {
-        image_draw_isometric_footprint_from_draw_tile(image_id, x, y, color_mask, draw_context.scale);
+    } else if (is_animated_water(image_id)) {
+        if (draw_context.advance_water_animation) {
+            image_id++;
+            if (image_id > draw_context.image_id_water_last) {
+                image_id = draw_context.image_id_water_first;
+            }
+            map_image_set_animation_frame(grid_offset, image_id);
+        }
+        image_draw_isometric_footprint_from_draw_tile(image_id, x, y, 0, draw_context.scale);
     }
-    if (!building_id && config_get(CONFIG_UI_SHOW_GRID) && draw_context.scale <= 2.0f) {
+    if (!map_building_at(grid_offset) && config_get(CONFIG_UI_SHOW_GRID) && draw_context.scale <= 2.0f) {
         static int grid_id = 0;
         if (!grid_id) {
             grid_id = assets_get_image_id("UI", "Grid_Full");
@@ -959,9 +1078,13 @@ void city_without_overlay_draw(int selected_figure_id, pixel_coordinate *figure_
     init_draw_context(selected_figure_id, figure_coord, highlighted_formation_id);
     int x, y, width, height;
     city_view_get_viewport(&x, &y, &width, &height);
-    graphics_fill_rect(x, y, width, height, COLOR_BLACK);
+    if (!restore_terrain_cache(x, y, width, height)) {
+        graphics_fill_rect(x, y, width, height, COLOR_BLACK);
+    }
     int should_mark_deleting = city_building_ghost_mark_deleting(tile);
     city_view_foreach_valid_map_tile(draw_footprint);
+    save_terrain_cache();
+    city_view_foreach_valid_map_tile(draw_uncached_footprint);
     if (!should_mark_deleting) {
         city_view_foreach_valid_map_tile_row(
             draw_top,
@@ -6,4 +6,10 @@
 
 void city_without_overlay_draw(int selected_figure_id, pixel_coordinate *figure_coord, const map_tile *tile);
 
+/**
+ * Forces the terrain footprints to be fully redrawn on the next frame, for when the images change
+ * or the render targets holding the saved terrain are lost
+ */
+void city_without_overlay_invalidate_terrain_cache(void);
+
 #endif // WIDGET_CITY_WITHOUT_OVERLAY_H
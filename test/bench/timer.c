@@ -0,0 +1,31 @@
+#include "bench/timer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+uint64_t bench_timer_micros(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (!frequency.QuadPart) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    uint64_t ticks = (uint64_t) counter.QuadPart;
+    uint64_t ticks_per_second = (uint64_t) frequency.QuadPart;
+    return (ticks / ticks_per_second) * 1000000 + (ticks % ticks_per_second) * 1000000 / ticks_per_second;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#endif
+}
+
+double bench_timer_seconds(void)
+{
+    return bench_timer_micros() / 1000000.0;
+}
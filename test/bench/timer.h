@@ -0,0 +1,18 @@
+#ifndef TEST_BENCH_TIMER_H
+#define TEST_BENCH_TIMER_H
+
+#include <stdint.h>
+
+/**
+ * Gets the time of a monotonic high resolution clock, for the benchmarks
+ * @return Current time in microseconds
+ */
+uint64_t bench_timer_micros(void);
+
+/**
+ * Gets the time of the same clock in seconds
+ * @return Current time in seconds
+ */
+double bench_timer_seconds(void);
+
+#endif // TEST_BENCH_TIMER_H
@@ -0,0 +1,127 @@
+#include "core/array.h"
+
+#include <stdio.h>
+
+#define ARRAY_SIZE_STEP 64
+#define CHURN_STEPS 200000
+#define MAX_LIVE_ITEMS 3000
+
+typedef struct {
+    unsigned int id;
+    int in_use;
+} item;
+
+static array(item) with_free_slots;
+static array(item) without_free_slots;
+
+static unsigned int random_state = 12345;
+
+static unsigned int next_random(void)
+{
+    random_state = random_state * 1103515245 + 12345;
+    return (random_state >> 16) & 0x7fff;
+}
+
+static void new_item(item *i, unsigned int position)
+{
+    i->id = position;
+}
+
+static int item_in_use(const item *i)
+{
+    return i->in_use;
+}
+
+static int allocate(int start_index, unsigned int *id)
+{
+    item *a;
+    item *b;
+    if (start_index) {
+        array_new_item_after_index(with_free_slots, 1, a);
+        array_new_item_after_index(without_free_slots, 1, b);
+    } else {
+        array_new_item(with_free_slots, a);
+        array_new_item(without_free_slots, b);
+    }
+    if (!a || !b) {
+        printf("Allocation failed\n");
+        return 0;
+    }
+    if (a->id != b->id) {
+        printf("Free slot allocation returned item %u, linear scan returned item %u\n", a->id, b->id);
+        return 0;
+    }
+    a->in_use = b->in_use = 1;
+    *id = a->id;
+    return 1;
+}
+
+static void release(unsigned int id)
+{
+    array_item(with_free_slots, id)->in_use = 0;
+    array_release_item(with_free_slots, id);
+    array_trim(with_free_slots);
+    array_item(without_free_slots, id)->in_use = 0;
+    array_trim(without_free_slots);
+}
+
+static int arrays_match(void)
+{
+    if (with_free_slots.size != without_free_slots.size) {
+        printf("Array sizes differ: %u and %u\n", with_free_slots.size, without_free_slots.size);
+        return 0;
+    }
+    for (unsigned int i = 0; i < with_free_slots.size; i++) {
+        if (array_item(with_free_slots, i)->in_use != array_item(without_free_slots, i)->in_use) {
+            printf("Item %u differs\n", i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(void)
+{
+    if (!array_init(with_free_slots, ARRAY_SIZE_STEP, new_item, item_in_use) ||
+        !array_enable_free_slots(with_free_slots) ||
+        !array_init(without_free_slots, ARRAY_SIZE_STEP, new_item, item_in_use)) {
+        printf("Unable to create arrays\n");
+        return 1;
+    }
+    unsigned int live[MAX_LIVE_ITEMS];
+    int num_live = 0;
+    for (int step = 0; step < CHURN_STEPS; step++) {
+        unsigned int action = next_random() % 100;
+        if (num_live < MAX_LIVE_ITEMS && (action < 55 || num_live == 0)) {
+            if (!allocate(action % 2, &live[num_live])) {
+                return 1;
+            }
+            num_live++;
+        } else if (action < 99) {
+            int index = next_random() % num_live;
+            release(live[index]);
+            live[index] = live[--num_live];
+        } else {
+            // packing moves items around, so forget about the old ids
+            array_pack(with_free_slots);
+            array_pack(without_free_slots);
+            num_live = 0;
+            item *i;
+            array_foreach(with_free_slots, i) {
+                if (i->in_use) {
+                    live[num_live++] = i->id;
+                }
+            }
+        }
+        if (step % 1000 == 0 && !arrays_match()) {
+            return 1;
+        }
+    }
+    if (!arrays_match()) {
+        return 1;
+    }
+    array_clear(with_free_slots);
+    array_clear(without_free_slots);
+    printf("Array free slot test passed\n");
+    return 0;
+}
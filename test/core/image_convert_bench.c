@@ -0,0 +1,85 @@
+#include "core/buffer.h"
+#include "core/image_convert.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DEFAULT_PIXELS (4 * 1024 * 1024)
+#define REPEATS 10
+// Row widths similar to the images of the game
+#define ROW_WIDTH 58
+
+static color_t to_32_bit(uint16_t c)
+{
+    return ALPHA_OPAQUE |
+        ((c & 0x7c00) << 9) | ((c & 0x7000) << 4) |
+        ((c & 0x3e0) << 6) | ((c & 0x380) << 1) |
+        ((c & 0x1f) << 3) | ((c & 0x1c) >> 2);
+}
+
+// The conversion loop the image loader used before, one buffer read per pixel
+static void convert_scalar(buffer *buf, color_t *dst, int pixels)
+{
+    for (int i = 0; i < pixels; i++) {
+        color_t color = to_32_bit(buffer_read_u16(buf));
+        dst[i] = color == COLOR_SG2_TRANSPARENT ? ALPHA_TRANSPARENT : color;
+    }
+}
+
+static void convert_runs(const uint8_t *src, color_t *dst, int pixels)
+{
+    for (int i = 0; i < pixels; i += ROW_WIDTH) {
+        int run = pixels - i < ROW_WIDTH ? pixels - i : ROW_WIDTH;
+        image_convert_555_with_transparency(&src[2 * i], &dst[i], run);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int pixels = argc > 1 ? atoi(argv[1]) : DEFAULT_PIXELS;
+    if (pixels <= 0) {
+        printf("Usage: imageconvertbench [pixels]\n");
+        return -1;
+    }
+    uint8_t *src = malloc(2 * (size_t) pixels);
+    color_t *dst = malloc(sizeof(color_t) * pixels);
+    if (!src || !dst) {
+        printf("Not enough memory\n");
+        return 1;
+    }
+    for (int i = 0; i < 2 * pixels; i++) {
+        src[i] = (uint8_t) (i * 7 + (i >> 9));
+    }
+    buffer buf;
+    clock_t start = clock();
+    for (int r = 0; r < REPEATS; r++) {
+        buffer_init(&buf, src, 2 * pixels);
+        for (int i = 0; i < pixels; i += ROW_WIDTH) {
+            convert_scalar(&buf, &dst[i], pixels - i < ROW_WIDTH ? pixels - i : ROW_WIDTH);
+        }
+    }
+    double scalar_seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    color_t scalar_checksum = 0;
+    for (int i = 0; i < pixels; i++) {
+        scalar_checksum = scalar_checksum * 31 + dst[i];
+    }
+
+    start = clock();
+    for (int r = 0; r < REPEATS; r++) {
+        convert_runs(src, dst, pixels);
+    }
+    double run_seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    color_t run_checksum = 0;
+    for (int i = 0; i < pixels; i++) {
+        run_checksum = run_checksum * 31 + dst[i];
+    }
+
+    double total = (double) pixels * REPEATS / 1000000;
+    printf("scalar: %.0f Mpixels/s\n", scalar_seconds > 0 ? total / scalar_seconds : 0.0);
+    printf("runs:   %.0f Mpixels/s\n", run_seconds > 0 ? total / run_seconds : 0.0);
+    printf("output %s\n", scalar_checksum == run_checksum ? "identical" : "DIFFERS");
+    free(src);
+    free(dst);
+    return scalar_checksum != run_checksum;
+}
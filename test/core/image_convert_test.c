@@ -0,0 +1,111 @@
+#include "core/image_convert.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_RUN 67
+#define ALIGNMENT_OFFSETS 4
+#define RANDOM_RUNS 20000
+
+static unsigned int random_state = 12345;
+
+static unsigned int next_random(void)
+{
+    random_state = random_state * 1103515245 + 12345;
+    return (random_state >> 16) & 0x7fff;
+}
+
+// The per-pixel conversion the image loader has always used
+static color_t to_32_bit(uint16_t c)
+{
+    return ALPHA_OPAQUE |
+        ((c & 0x7c00) << 9) | ((c & 0x7000) << 4) |
+        ((c & 0x3e0) << 6) | ((c & 0x380) << 1) |
+        ((c & 0x1f) << 3) | ((c & 0x1c) >> 2);
+}
+
+static void convert_reference(const uint8_t *src, color_t *dst, int count, int resolve_transparency)
+{
+    for (int i = 0; i < count; i++) {
+        color_t color = to_32_bit((uint16_t) (src[2 * i] | (src[2 * i + 1] << 8)));
+        dst[i] = resolve_transparency && color == COLOR_SG2_TRANSPARENT ? ALPHA_TRANSPARENT : color;
+    }
+}
+
+static int check_run(const uint8_t *src, int count, int resolve_transparency)
+{
+    // One extra pixel on each side to catch writes outside the run
+    color_t expected[MAX_RUN + 2];
+    color_t actual[MAX_RUN + 2];
+    memset(expected, 0xaa, sizeof(expected));
+    memset(actual, 0xaa, sizeof(actual));
+    convert_reference(src, &expected[1], count, resolve_transparency);
+    if (resolve_transparency) {
+        image_convert_555_with_transparency(src, &actual[1], count);
+    } else {
+        image_convert_555(src, &actual[1], count);
+    }
+    if (memcmp(expected, actual, sizeof(expected)) != 0) {
+        for (int i = 0; i < count + 2; i++) {
+            if (expected[i] != actual[i]) {
+                printf("Run of %d pixels, transparency %d: pixel %d is %08x instead of %08x\n",
+                    count, resolve_transparency, i - 1, actual[i], expected[i]);
+                break;
+            }
+        }
+        return 0;
+    }
+    return 1;
+}
+
+static int check_all_colors(int resolve_transparency)
+{
+    static uint8_t src[65536 * 2];
+    static color_t expected[65536];
+    static color_t actual[65536];
+    for (int c = 0; c < 65536; c++) {
+        src[2 * c] = c & 0xff;
+        src[2 * c + 1] = c >> 8;
+    }
+    convert_reference(src, expected, 65536, resolve_transparency);
+    if (resolve_transparency) {
+        image_convert_555_with_transparency(src, actual, 65536);
+    } else {
+        image_convert_555(src, actual, 65536);
+    }
+    for (int c = 0; c < 65536; c++) {
+        if (expected[c] != actual[c]) {
+            printf("Color %04x, transparency %d: %08x instead of %08x\n",
+                c, resolve_transparency, actual[c], expected[c]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(void)
+{
+    if (!check_all_colors(0) || !check_all_colors(1)) {
+        return 1;
+    }
+    uint8_t src[2 * MAX_RUN + ALIGNMENT_OFFSETS];
+    for (int run = 0; run < RANDOM_RUNS; run++) {
+        for (size_t i = 0; i < sizeof(src); i++) {
+            src[i] = next_random() & 0xff;
+        }
+        // Make sure the transparent color shows up, with and without the unused top bit
+        int transparent_pixels = next_random() % 8;
+        for (int i = 0; i < transparent_pixels; i++) {
+            int pixel = next_random() % MAX_RUN;
+            src[2 * pixel] = 0x1f;
+            src[2 * pixel + 1] = next_random() % 2 ? 0xf8 : 0x78;
+        }
+        int offset = run % ALIGNMENT_OFFSETS;
+        int count = next_random() % (MAX_RUN + 1);
+        if (!check_run(&src[offset], count, run % 2)) {
+            return 1;
+        }
+    }
+    printf("Image conversion test passed\n");
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "bench/timer.h"
+#include "core/smacker.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_RUNS 5
+
+static uint32_t checksum_bytes(uint32_t hash, const uint8_t *data, size_t length)
+{
+    // FNV-1a
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t checksum_frame(smacker s, uint32_t hash, int width, int height)
+{
+    hash = checksum_bytes(hash, smacker_get_frame_video(s), (size_t) width * height);
+    hash = checksum_bytes(hash, (const uint8_t *) smacker_get_frame_palette(s), 256 * sizeof(uint32_t));
+    for (int track = 0; track < 7; track++) {
+        int size = smacker_get_frame_audio_size(s, track);
+        if (size > 0) {
+            hash = checksum_bytes(hash, smacker_get_frame_audio(s, track), size);
+        }
+    }
+    return hash;
+}
+
+static int decode_video(const char *filename, int *frames, uint32_t *checksum, double *seconds)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        printf("Unable to open %s\n", filename);
+        return 0;
+    }
+    double start = bench_timer_seconds();
+    smacker s = smacker_open(fp);
+    if (!s) {
+        printf("Unable to read %s as a smacker video\n", filename);
+        return 0;
+    }
+    int width, height;
+    smacker_get_video_info(s, &width, &height, 0);
+    smacker_frame_status status = smacker_first_frame(s);
+    double decode_time = 0;
+    *frames = 0;
+    *checksum = 2166136261u;
+    while (status == SMACKER_FRAME_OK) {
+        decode_time += bench_timer_seconds() - start;
+        (*frames)++;
+        // The checksum is not part of the decoding time
+        *checksum = checksum_frame(s, *checksum, width, height);
+        start = bench_timer_seconds();
+        status = smacker_next_frame(s);
+    }
+    smacker_close(s);
+    *seconds = decode_time;
+    if (status == SMACKER_FRAME_ERROR) {
+        printf("Error decoding frame %d of %s\n", *frames, filename);
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *filename = 0;
+    int runs = DEFAULT_RUNS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else {
+            filename = argv[i];
+        }
+    }
+    if (!filename || runs <= 0) {
+        printf("Usage: smackerbench [-r runs] <file.smk>\n");
+        return -1;
+    }
+    int frames = 0;
+    uint32_t checksum = 0;
+    double best = 0;
+    for (int run = 0; run < runs; run++) {
+        int run_frames;
+        uint32_t run_checksum;
+        double seconds;
+        if (!decode_video(filename, &run_frames, &run_checksum, &seconds)) {
+            return 1;
+        }
+        if (run > 0 && (run_frames != frames || run_checksum != checksum)) {
+            printf("Decoding is not deterministic: run %d differs\n", run + 1);
+            return 1;
+        }
+        frames = run_frames;
+        checksum = run_checksum;
+        if (run == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    printf("%s: %d frames, best of %d runs: %.1f ms, %.1f fps, checksum %08x\n",
+        filename, frames, runs, best * 1000, best > 0 ? frames / best : 0.0, (unsigned int) checksum);
+    return 0;
+}
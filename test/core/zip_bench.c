@@ -0,0 +1,156 @@
+#include "bench/timer.h"
+#include "core/zip.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_RUNS 20
+#define UNCOMPRESSED 0x80000000
+
+typedef struct {
+    int compressed;
+    int length_in_bytes;
+} save_part;
+
+// Parts of an original Caesar 3 save game, up to the last compressed part
+static const save_part SAVE_GAME_PARTS[] = {
+    {0, 4}, {0, 4},
+    {1, 52488}, {1, 26244}, {1, 52488}, {1, 52488}, {1, 26244}, {1, 52488}, {1, 26244}, {1, 26244}, {0, 26244},
+    {1, 26244}, {1, 26244}, {1, 26244}, {1, 26244}, {1, 26244},
+    {1, 128000}, {1, 1200}, {1, 300000}, {1, 6400}, {0, 12}, {1, 36136}, {0, 2}, {0, 64}, {0, 4}, {1, 256000},
+    {0, 4}, {0, 20}, {0, 8}, {0, 8}, {0, 8}, {0, 132}, {0, 8}, {0, 8}, {0, 12}, {1, 2706},
+    {0, 128}, {0, 128}, {0, 84}, {0, 60}, {0, 1720}, {0, 4}, {0, 60}, {0, 4}, {1, 16000},
+    {0, 12}, {0, 10}, {0, 80}, {0, 80}, {0, 8}, {0, 4}, {0, 12}, {1, 3232}, {0, 4}, {0, 8960}, {0, 4}, {0, 4804},
+    {1, 1000}, {1, 1000}, {1, 4000}, {0, 32}, {0, 16}, {0, 20}, {0, 6400}, {0, 32}, {0, 24}, {0, 4}, {0, 16},
+    {1, 1280}, {1, 1280},
+    {0, 0}
+};
+
+typedef struct {
+    const uint8_t *data;
+    int compressed_size;
+    int size;
+} compressed_chunk;
+
+static uint8_t *read_file(const char *filename, long *length)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    *length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *data = malloc(*length);
+    if (data && fread(data, 1, *length, fp) != (size_t) *length) {
+        free(data);
+        data = 0;
+    }
+    fclose(fp);
+    return data;
+}
+
+static int find_chunks(const uint8_t *data, long length, compressed_chunk *chunks)
+{
+    long offset = 0;
+    int num_chunks = 0;
+    for (int i = 0; SAVE_GAME_PARTS[i].length_in_bytes; i++) {
+        const save_part *part = &SAVE_GAME_PARTS[i];
+        if (!part->compressed) {
+            offset += part->length_in_bytes;
+            continue;
+        }
+        if (offset + 4 > length) {
+            return 0;
+        }
+        const uint8_t *p = &data[offset];
+        uint32_t input_size = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+        offset += 4;
+        if (input_size == UNCOMPRESSED) {
+            offset += part->length_in_bytes;
+            continue;
+        }
+        if (offset + input_size > length) {
+            return 0;
+        }
+        chunks[num_chunks].data = &data[offset];
+        chunks[num_chunks].compressed_size = input_size;
+        chunks[num_chunks].size = part->length_in_bytes;
+        num_chunks++;
+        offset += input_size;
+    }
+    return num_chunks;
+}
+
+int main(int argc, char **argv)
+{
+    int runs = DEFAULT_RUNS;
+    int first_file = 1;
+    if (argc > 2 && strcmp(argv[1], "-r") == 0) {
+        runs = atoi(argv[2]);
+        first_file = 3;
+    }
+    if (first_file >= argc || runs <= 0) {
+        printf("Usage: zipbench [-r runs] <file.sav> ...\n");
+        printf("Decompresses the parts of original Caesar 3 saves, reporting the throughput\n");
+        return -1;
+    }
+    uint8_t *output = malloc(300000);
+    if (!output) {
+        return 1;
+    }
+    double total_seconds = 0;
+    double total_bytes = 0;
+    double total_compressed_bytes = 0;
+    for (int f = first_file; f < argc; f++) {
+        long length;
+        uint8_t *data = read_file(argv[f], &length);
+        if (!data) {
+            printf("Unable to read %s\n", argv[f]);
+            free(output);
+            return 1;
+        }
+        compressed_chunk chunks[sizeof(SAVE_GAME_PARTS) / sizeof(save_part)];
+        int num_chunks = find_chunks(data, length, chunks);
+        if (!num_chunks) {
+            printf("%s is not an original save game\n", argv[f]);
+            free(data);
+            free(output);
+            return 1;
+        }
+        double best = 0;
+        for (int run = 0; run < runs; run++) {
+            double start = bench_timer_seconds();
+            for (int i = 0; i < num_chunks; i++) {
+                if (!zip_decompress(chunks[i].data, chunks[i].compressed_size, output, chunks[i].size)) {
+                    printf("Unable to decompress part %d of %s\n", i, argv[f]);
+                    free(data);
+                    free(output);
+                    return 1;
+                }
+            }
+            double seconds = bench_timer_seconds() - start;
+            if (run == 0 || seconds < best) {
+                best = seconds;
+            }
+        }
+        int bytes = 0;
+        int compressed_bytes = 0;
+        for (int i = 0; i < num_chunks; i++) {
+            bytes += chunks[i].size;
+            compressed_bytes += chunks[i].compressed_size;
+        }
+        printf("%s: %d parts, %d -> %d bytes, best of %d runs: %.3f ms, %.1f MB/s\n",
+            argv[f], num_chunks, compressed_bytes, bytes, runs, best * 1000, bytes / best / 1000000);
+        total_seconds += best;
+        total_bytes += bytes;
+        total_compressed_bytes += compressed_bytes;
+        free(data);
+    }
+    printf("Total: %.0f -> %.0f bytes in %.3f ms, %.1f MB/s\n",
+        total_compressed_bytes, total_bytes, total_seconds * 1000, total_bytes / total_seconds / 1000000);
+    free(output);
+    return 0;
+}
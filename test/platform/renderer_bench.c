@@ -0,0 +1,330 @@
+#include "graphics/color.h"
+#include "graphics/renderer.h"
+#include "platform/renderer.h"
+
+#include "SDL.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_FRAMES 300
+#define DEFAULT_SPRITES 20000
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 800
+#define ATLAS_PAGES 2
+#define ATLAS_SIZE 1024
+#define SPRITE_WIDTH 58
+#define SPRITE_HEIGHT 30
+// Consecutive sprites on the same atlas page, roughly what a city row of terrain and buildings looks like
+#define SPRITES_PER_RUN 24
+// Tells ctest that the comparison could not run, rather than that it failed
+#define SKIP_RETURN_CODE 77
+
+static image *create_images(int num_sprites)
+{
+    image *images = malloc(sizeof(image) * num_sprites);
+    if (!images) {
+        return 0;
+    }
+    memset(images, 0, sizeof(image) * num_sprites);
+    int per_row = ATLAS_SIZE / SPRITE_WIDTH;
+    int per_column = ATLAS_SIZE / SPRITE_HEIGHT;
+    for (int i = 0; i < num_sprites; i++) {
+        int page = (i / SPRITES_PER_RUN) % ATLAS_PAGES;
+        int slot = rand() % (per_row * per_column);
+        images[i].width = SPRITE_WIDTH;
+        images[i].height = SPRITE_HEIGHT;
+        images[i].is_isometric = 1;
+        images[i].atlas.id = (ATLAS_MAIN << IMAGE_ATLAS_BIT_OFFSET) | page;
+        images[i].atlas.x_offset = (slot % per_row) * SPRITE_WIDTH;
+        images[i].atlas.y_offset = (slot / per_row) * SPRITE_HEIGHT;
+    }
+    return images;
+}
+
+static int create_atlas(void)
+{
+    const graphics_renderer_interface *renderer = graphics_renderer();
+    const image_atlas_data *atlas = renderer->prepare_image_atlas(ATLAS_MAIN, ATLAS_PAGES, ATLAS_SIZE, ATLAS_SIZE);
+    if (!atlas) {
+        return 0;
+    }
+    for (int page = 0; page < atlas->num_images; page++) {
+        color_t *pixels = atlas->buffers[page];
+        int width = atlas->image_widths[page];
+        for (int y = 0; y < atlas->image_heights[page]; y++) {
+            for (int x = 0; x < width; x++) {
+                // Leave transparent corners, like the isometric tiles have
+                int tile_x = x % SPRITE_WIDTH;
+                int tile_y = y % SPRITE_HEIGHT;
+                int inside = abs(2 * tile_x - SPRITE_WIDTH) + abs(4 * tile_y - 2 * SPRITE_HEIGHT) <= 2 * SPRITE_WIDTH;
+                color_t color = ALPHA_OPAQUE | ((x * 7 + y * 13 + page * 101) & COLOR_CHANNEL_RGB);
+                pixels[y * width + x] = inside ? color : ALPHA_TRANSPARENT;
+            }
+        }
+    }
+    return renderer->create_image_atlas(atlas, 1);
+}
+
+static void draw_frame(const image *images, const int *positions, int num_sprites)
+{
+    const graphics_renderer_interface *renderer = graphics_renderer();
+    renderer->clear_screen();
+    renderer->set_clip_rectangle(0, 24, SCREEN_WIDTH - 160, SCREEN_HEIGHT - 24);
+    for (int i = 0; i < num_sprites; i++) {
+        // Every sixteenth sprite is tinted, like buildings under the mouse or in an overlay
+        color_t color = (i & 15) == 0 ? COLOR_MASK_RED : COLOR_MASK_NONE;
+        renderer->draw_image(&images[i], positions[2 * i], positions[2 * i + 1], color, 1.0f);
+    }
+    renderer->reset_clip_rectangle();
+    platform_renderer_render();
+}
+
+// Covers what the batched path has to reproduce: tints with and without alpha, a different scale on each axis,
+// texture switches between the atlas pages and unbatched draws (rotated images and rectangles) in between
+static void draw_comparison_frame(const image *images, const int *positions, int num_sprites)
+{
+    static const color_t colors[] = {
+        COLOR_MASK_NONE, COLOR_MASK_RED, COLOR_MASK_GREEN, ALPHA_MASK_SEMI_TRANSPARENT
+    };
+    static const float scales[] = { 1.0f, 0.5f, 2.0f, 1.5f };
+    const graphics_renderer_interface *renderer = graphics_renderer();
+    renderer->clear_screen();
+    renderer->set_clip_rectangle(0, 24, SCREEN_WIDTH - 160, SCREEN_HEIGHT - 24);
+    for (int i = 0; i < num_sprites; i++) {
+        color_t color = colors[(i / 3) % 4];
+        float x = (float) positions[2 * i];
+        float y = (float) positions[2 * i + 1];
+        switch (i % 7) {
+            case 0:
+                renderer->draw_image_advanced(&images[i], x, y, color, 1.0f, 0.75f, 0.0, 1);
+                break;
+            case 1:
+                renderer->draw_image_advanced(&images[i], x, y, color, 1.0f, 1.0f, 90.0, 1);
+                break;
+            case 2:
+                if ((i & 63) == 2) {
+                    renderer->fill_rect(positions[2 * i], 40, positions[2 * i + 1], 20, COLOR_MASK_BLUE);
+                }
+                // fall through
+            default:
+                renderer->draw_image(&images[i], positions[2 * i], positions[2 * i + 1], color, scales[i % 4]);
+                break;
+        }
+    }
+    renderer->reset_clip_rectangle();
+}
+
+static int read_frame(color_t *pixels)
+{
+    return graphics_renderer()->save_screen_buffer(pixels, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_WIDTH);
+}
+
+static void save_frame(const color_t *pixels, const char *filename)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom((void *) pixels, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+        SCREEN_WIDTH * sizeof(color_t), SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) {
+        printf("Unable to save %s: %s\n", filename, SDL_GetError());
+        return;
+    }
+    if (SDL_SaveBMP(surface, filename) != 0) {
+        printf("Unable to save %s: %s\n", filename, SDL_GetError());
+    }
+    SDL_FreeSurface(surface);
+}
+
+static int channel_difference(color_t a, color_t b, int shift)
+{
+    return abs((int) ((a >> shift) & 0xff) - (int) ((b >> shift) & 0xff));
+}
+
+static int run_comparison(int num_sprites, const char *output_prefix)
+{
+    image *images = create_images(num_sprites);
+    int *positions = malloc(sizeof(int) * 2 * num_sprites);
+    color_t *single = malloc(sizeof(color_t) * SCREEN_WIDTH * SCREEN_HEIGHT);
+    color_t *batched = malloc(sizeof(color_t) * SCREEN_WIDTH * SCREEN_HEIGHT);
+    int result = 1;
+    if (!images || !positions || !single || !batched) {
+        printf("Out of memory\n");
+        goto cleanup;
+    }
+    for (int i = 0; i < num_sprites; i++) {
+        positions[2 * i] = rand() % SCREEN_WIDTH - SPRITE_WIDTH / 2;
+        positions[2 * i + 1] = rand() % SCREEN_HEIGHT - SPRITE_HEIGHT / 2;
+    }
+    platform_renderer_set_sprite_batching(0);
+    draw_comparison_frame(images, positions, num_sprites);
+    if (!read_frame(single)) {
+        printf("Unable to read the frame: %s\n", SDL_GetError());
+        goto cleanup;
+    }
+    platform_renderer_set_sprite_batching(1);
+    if (!platform_renderer_is_sprite_batching()) {
+        printf("Sprite batching needs SDL 2.0.18 or later and a renderer other than software, nothing to compare\n");
+        result = SKIP_RETURN_CODE;
+        goto cleanup;
+    }
+    draw_comparison_frame(images, positions, num_sprites);
+    if (!read_frame(batched)) {
+        printf("Unable to read the frame: %s\n", SDL_GetError());
+        goto cleanup;
+    }
+    platform_renderer_set_sprite_batching(0);
+
+    int different_pixels = 0;
+    int max_difference = 0;
+    for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
+        if (single[i] == batched[i]) {
+            continue;
+        }
+        different_pixels++;
+        for (int shift = 0; shift < 32; shift += 8) {
+            int difference = channel_difference(single[i], batched[i], shift);
+            if (difference > max_difference) {
+                max_difference = difference;
+            }
+        }
+    }
+    // The batched quads use the same coordinates as SDL_RenderCopyExF, so any difference is a bug
+    printf("%d of %d pixels differ between single and batched sprites, largest channel difference %d\n",
+        different_pixels, SCREEN_WIDTH * SCREEN_HEIGHT, max_difference);
+    result = different_pixels ? 1 : 0;
+    if (output_prefix) {
+        char filename[256];
+        snprintf(filename, sizeof(filename), "%s_single.bmp", output_prefix);
+        save_frame(single, filename);
+        snprintf(filename, sizeof(filename), "%s_batched.bmp", output_prefix);
+        save_frame(batched, filename);
+    }
+
+cleanup:
+    free(images);
+    free(positions);
+    free(single);
+    free(batched);
+    return result;
+}
+
+static int compare_ticks(const void *a, const void *b)
+{
+    Uint64 va = *(const Uint64 *) a;
+    Uint64 vb = *(const Uint64 *) b;
+    return va < vb ? -1 : va > vb;
+}
+
+static double ticks_to_millis(Uint64 ticks)
+{
+    return ticks * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static int run_benchmark(int frames, int num_sprites)
+{
+    image *images = create_images(num_sprites);
+    int *positions = malloc(sizeof(int) * 2 * num_sprites);
+    Uint64 *frame_ticks = malloc(sizeof(Uint64) * frames);
+    if (!images || !positions || !frame_ticks) {
+        free(images);
+        free(positions);
+        free(frame_ticks);
+        printf("Out of memory\n");
+        return 0;
+    }
+    for (int i = 0; i < num_sprites; i++) {
+        positions[2 * i] = rand() % SCREEN_WIDTH - SPRITE_WIDTH / 2;
+        positions[2 * i + 1] = rand() % SCREEN_HEIGHT - SPRITE_HEIGHT / 2;
+    }
+    // Warm up the texture uploads and driver caches
+    draw_frame(images, positions, num_sprites);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int f = 0; f < frames; f++) {
+        Uint64 frame_start = SDL_GetPerformanceCounter();
+        draw_frame(images, positions, num_sprites);
+        frame_ticks[f] = SDL_GetPerformanceCounter() - frame_start;
+    }
+    double total = ticks_to_millis(SDL_GetPerformanceCounter() - start);
+    qsort(frame_ticks, frames, sizeof(Uint64), compare_ticks);
+
+    printf("%d frames of %d sprites in %.1f ms: avg %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms, %.1f fps\n",
+        frames, num_sprites, total, total / frames,
+        ticks_to_millis(frame_ticks[frames / 2]), ticks_to_millis(frame_ticks[(frames * 99 + 99) / 100 - 1]),
+        ticks_to_millis(frame_ticks[frames - 1]), total > 0 ? frames * 1000.0 / total : 0.0);
+
+    free(images);
+    free(positions);
+    free(frame_ticks);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = DEFAULT_FRAMES;
+    int num_sprites = DEFAULT_SPRITES;
+    int batching = 1;
+    int compare = 0;
+    const char *output_prefix = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0) {
+            compare = 1;
+        } else if (strcmp(argv[i], "-n") == 0) {
+            batching = 0;
+        } else if (i + 1 < argc && strcmp(argv[i], "-f") == 0) {
+            frames = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) {
+            num_sprites = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "-o") == 0) {
+            output_prefix = argv[++i];
+        } else {
+            frames = 0;
+            break;
+        }
+    }
+    if (frames <= 0 || num_sprites <= 0) {
+        printf("Usage: rendererbench [-n] [-f frames] [-s sprites]\n");
+        printf("       rendererbench -c [-s sprites] [-o bmp prefix]\n");
+        printf("  -n: draw every sprite with its own copy call instead of batching them\n");
+        printf("  -c: compare a frame drawn with and without batching, optionally saving both as bitmaps\n");
+        return -1;
+    }
+    // Draws to an offscreen window, so no display is needed. The offscreen driver gets an accelerated renderer
+    // through EGL where there is one (Mesa's llvmpipe is enough), otherwise the dummy driver and the software
+    // renderer are used. SDL_VIDEODRIVER and SDL_RENDER_DRIVER in the environment override both.
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+            printf("Unable to initialize SDL: %s\n", SDL_GetError());
+            return 1;
+        }
+    }
+    SDL_Window *window = SDL_CreateWindow("rendererbench", 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_HIDDEN);
+    if (!window || !platform_renderer_init(window) ||
+        !platform_renderer_create_render_texture(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        printf("Unable to create renderer: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    graphics_renderer()->update_scale(100);
+    int result = 1;
+    if (create_atlas()) {
+        srand(1);
+        if (compare) {
+            result = run_comparison(num_sprites, output_prefix);
+        } else {
+            platform_renderer_set_sprite_batching(batching);
+            if (batching && !platform_renderer_is_sprite_batching()) {
+                printf("Sprite batching is not available with this renderer, drawing every sprite on its own\n");
+            }
+            result = run_benchmark(frames, num_sprites) ? 0 : 1;
+        }
+    } else {
+        printf("Unable to create texture atlas\n");
+    }
+    platform_renderer_destroy();
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return result;
+}
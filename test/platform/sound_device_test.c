@@ -0,0 +1,195 @@
+#include "sound/device.h"
+
+#include "SDL.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TOTAL_FILES 140
+#define SAMPLES_PER_FILE 64
+// Long enough to still be playing while all other files go through the cache
+#define LONG_FILE "soundcachelong.wav"
+#define SAMPLES_IN_LONG_FILE (22050 * 30)
+
+static int failures;
+
+static void expect(int condition, const char *message)
+{
+    if (!condition) {
+        printf("FAIL: %s\n", message);
+        failures++;
+    }
+}
+
+static void write_u16(FILE *fp, unsigned int value)
+{
+    fputc(value & 0xff, fp);
+    fputc((value >> 8) & 0xff, fp);
+}
+
+static void write_u32(FILE *fp, unsigned int value)
+{
+    write_u16(fp, value & 0xffff);
+    write_u16(fp, value >> 16);
+}
+
+static int write_wav(const char *filename, unsigned int samples)
+{
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        return 0;
+    }
+    unsigned int data_size = samples * 2;
+    fwrite("RIFF", 1, 4, fp);
+    write_u32(fp, 36 + data_size);
+    fwrite("WAVEfmt ", 1, 8, fp);
+    write_u32(fp, 16);
+    write_u16(fp, 1); // PCM
+    write_u16(fp, 1); // mono
+    write_u32(fp, 22050);
+    write_u32(fp, 22050 * 2);
+    write_u16(fp, 2);
+    write_u16(fp, 16);
+    fwrite("data", 1, 4, fp);
+    write_u32(fp, data_size);
+    for (unsigned int i = 0; i < samples; i++) {
+        write_u16(fp, 0);
+    }
+    fclose(fp);
+    return 1;
+}
+
+static void get_filename(int index, char *filename)
+{
+    snprintf(filename, 32, "soundcache%d.wav", index);
+}
+
+static void test_repeated_files_are_decoded_once(void)
+{
+    char filename[32];
+    get_filename(0, filename);
+    sound_device_chunk_cache_stats before, after;
+    sound_device_get_chunk_cache_stats(&before);
+
+    expect(sound_device_play_file_on_channel(filename, SOUND_TYPE_CITY, 100), "first play succeeds");
+    sound_device_stop_type(SOUND_TYPE_CITY);
+    expect(sound_device_play_file_on_channel(filename, SOUND_TYPE_CITY, 100), "second play succeeds");
+    // The same file on another channel type shares the decoded chunk
+    expect(sound_device_play_file_on_channel(filename, SOUND_TYPE_EFFECTS, 50), "play on effects succeeds");
+
+    sound_device_get_chunk_cache_stats(&after);
+    expect(after.misses - before.misses == 1, "file is decoded once");
+    expect(after.hits - before.hits == 2, "later plays are cache hits");
+    expect(after.chunks == 1, "one chunk is cached");
+    expect(after.bytes > 0, "cached bytes are counted");
+
+    sound_device_stop_type(SOUND_TYPE_CITY);
+    sound_device_stop_type(SOUND_TYPE_EFFECTS);
+}
+
+static void test_least_recently_used_are_evicted(void)
+{
+    char filename[32];
+    sound_device_chunk_cache_stats before, after;
+    sound_device_get_chunk_cache_stats(&before);
+
+    for (int i = 1; i < TOTAL_FILES; i++) {
+        get_filename(i, filename);
+        expect(sound_device_play_file_on_channel(filename, SOUND_TYPE_CITY, 100), "play succeeds");
+        sound_device_stop_type(SOUND_TYPE_CITY);
+    }
+    sound_device_get_chunk_cache_stats(&after);
+    expect(after.misses - before.misses == TOTAL_FILES - 1, "every new file is decoded");
+    expect(after.evictions > before.evictions, "old chunks are evicted");
+    expect(after.chunks < TOTAL_FILES, "the number of cached chunks is bounded");
+
+    // The first file was the least recently used, so it must be decoded again
+    get_filename(0, filename);
+    sound_device_get_chunk_cache_stats(&before);
+    expect(sound_device_play_file_on_channel(filename, SOUND_TYPE_CITY, 100), "play evicted file succeeds");
+    sound_device_get_chunk_cache_stats(&after);
+    expect(after.misses - before.misses == 1, "evicted file is decoded again");
+
+    // The last file was used most recently and is still cached
+    get_filename(TOTAL_FILES - 1, filename);
+    expect(sound_device_play_file_on_channel(filename, SOUND_TYPE_EFFECTS, 100), "play recent file succeeds");
+    sound_device_get_chunk_cache_stats(&before);
+    expect(before.hits - after.hits == 1, "recent file is a cache hit");
+
+    sound_device_stop_type(SOUND_TYPE_CITY);
+    sound_device_stop_type(SOUND_TYPE_EFFECTS);
+}
+
+static void test_playing_chunks_are_not_evicted(void)
+{
+    char filename[32];
+    sound_device_chunk_cache_stats before, after;
+    expect(sound_device_play_file_on_channel(LONG_FILE, SOUND_TYPE_SPEECH, 100), "play long file succeeds");
+    sound_device_get_chunk_cache_stats(&before);
+
+    // Enough other files to evict every chunk that is not in use
+    for (int i = 0; i < TOTAL_FILES; i++) {
+        get_filename(i, filename);
+        expect(sound_device_play_file_on_channel(filename, SOUND_TYPE_CITY, 100), "play succeeds");
+        sound_device_stop_type(SOUND_TYPE_CITY);
+    }
+    sound_device_get_chunk_cache_stats(&after);
+    expect(after.evictions > before.evictions, "chunks that are not playing are evicted");
+    expect(sound_device_is_file_playing_on_channel(LONG_FILE, SOUND_TYPE_SPEECH), "long file is still playing");
+
+    // The chunk that is playing must not have been freed, so playing it elsewhere shares it
+    sound_device_get_chunk_cache_stats(&before);
+    expect(sound_device_play_file_on_channel(LONG_FILE, SOUND_TYPE_EFFECTS, 100), "play long file again succeeds");
+    sound_device_get_chunk_cache_stats(&after);
+    expect(after.misses == before.misses, "playing file is not decoded again");
+    expect(after.hits - before.hits == 1, "playing file is a cache hit");
+
+    sound_device_stop_type(SOUND_TYPE_SPEECH);
+    sound_device_stop_type(SOUND_TYPE_EFFECTS);
+}
+
+int main(void)
+{
+    char filename[32];
+    for (int i = 0; i < TOTAL_FILES; i++) {
+        get_filename(i, filename);
+        if (!write_wav(filename, SAMPLES_PER_FILE)) {
+            printf("Unable to write %s\n", filename);
+            return 1;
+        }
+    }
+    if (!write_wav(LONG_FILE, SAMPLES_IN_LONG_FILE)) {
+        printf("Unable to write %s\n", LONG_FILE);
+        return 1;
+    }
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        printf("Unable to initialize SDL audio: %s\n", SDL_GetError());
+        return 1;
+    }
+    sound_device_open();
+    sound_device_init_channels();
+
+    test_repeated_files_are_decoded_once();
+    test_least_recently_used_are_evicted();
+    test_playing_chunks_are_not_evicted();
+
+    sound_device_close();
+    sound_device_chunk_cache_stats stats;
+    sound_device_get_chunk_cache_stats(&stats);
+    expect(stats.chunks == 0 && stats.bytes == 0, "closing the device frees the cache");
+
+    SDL_Quit();
+    for (int i = 0; i < TOTAL_FILES; i++) {
+        get_filename(i, filename);
+        remove(filename);
+    }
+    remove(LONG_FILE);
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("All sound cache checks passed\n");
+    return 0;
+}
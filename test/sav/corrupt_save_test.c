@@ -0,0 +1,178 @@
+#include "core/buffer.h"
+#include "game/file.h"
+#include "game/file_io.h"
+#include "game/game.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INPUT_FILE "tower.sav"
+#define OUTPUT_FILE "corruptsave.sav"
+// Campaign mission, file version and resource version come before the piece index
+#define PIECE_INDEX_OFFSET 12
+#define PIECE_INDEX_HEADER_SIZE 8
+#define PIECE_INDEX_ENTRY_SIZE 12
+#define NUM_NEGATIVE_SIZES 3
+// More than the initial read buffer of the loader, so a read that runs on to the end of the file overflows it
+#define TRAILING_BYTES 2000000
+
+static int failures;
+
+static void expect(int condition, const char *message)
+{
+    if (!condition) {
+        printf("FAIL: %s\n", message);
+        failures++;
+    }
+}
+
+static uint8_t *read_file(const char *filename, size_t *size)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    *size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *data = malloc(*size);
+    if (data && fread(data, 1, *size, fp) != *size) {
+        free(data);
+        data = 0;
+    }
+    fclose(fp);
+    return data;
+}
+
+static int write_file(const char *filename, const uint8_t *data, size_t size)
+{
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        return 0;
+    }
+    int result = fwrite(data, 1, size, fp) == size;
+    fclose(fp);
+    return result;
+}
+
+static int read_i32_at(const uint8_t *data, size_t offset)
+{
+    buffer buf;
+    buffer_init(&buf, (uint8_t *) data + offset, 4);
+    return buffer_read_i32(&buf);
+}
+
+static void write_i32_at(uint8_t *data, size_t offset, int value)
+{
+    buffer buf;
+    buffer_init(&buf, data + offset, 4);
+    buffer_write_i32(&buf, value);
+}
+
+// Uses the piece index to find the second compressed piece, so that the first one is already in the
+// read buffer when its size is read. Returns the offset of its compressed size.
+static size_t find_second_compressed_piece(const uint8_t *data, size_t size, int *first_piece_size)
+{
+    int index_size = read_i32_at(data, PIECE_INDEX_OFFSET);
+    if (index_size < PIECE_INDEX_HEADER_SIZE || PIECE_INDEX_OFFSET + 4 + (size_t) index_size > size) {
+        return 0;
+    }
+    const uint8_t *index = data + PIECE_INDEX_OFFSET + 4;
+    int num_pieces = read_i32_at(index, 4);
+    if (PIECE_INDEX_HEADER_SIZE + num_pieces * PIECE_INDEX_ENTRY_SIZE > index_size) {
+        return 0;
+    }
+    int found = 0;
+    for (int i = 0; i < num_pieces; i++) {
+        const uint8_t *entry = index + PIECE_INDEX_HEADER_SIZE + i * PIECE_INDEX_ENTRY_SIZE;
+        size_t offset = (unsigned int) read_i32_at(entry, 0);
+        int length = read_i32_at(entry, 4);
+        // A compressed piece starts with the size of the compressed data that follows
+        if (offset == PIECE_INDEX_OFFSET || length <= 8 || offset + length > size ||
+            read_i32_at(data, offset) != length - 4) {
+            continue;
+        }
+        if (found++) {
+            return offset;
+        }
+        *first_piece_size = length - 4;
+    }
+    return 0;
+}
+
+static int load_modified_save(const uint8_t *data, size_t size, int add_trailing_bytes)
+{
+    if (!write_file(OUTPUT_FILE, data, size)) {
+        printf("Unable to write %s\n", OUTPUT_FILE);
+        exit(1);
+    }
+    if (add_trailing_bytes) {
+        FILE *fp = fopen(OUTPUT_FILE, "ab");
+        for (int i = 0; fp && i < TRAILING_BYTES; i++) {
+            fputc(0, fp);
+        }
+        if (fp) {
+            fclose(fp);
+        }
+    }
+    return game_file_io_read_saved_game(OUTPUT_FILE, 0);
+}
+
+static void test_corrupt_piece_sizes(void)
+{
+    size_t size;
+    uint8_t *data = read_file(OUTPUT_FILE, &size);
+    expect(data != 0, "written save can be read back");
+    if (!data) {
+        return;
+    }
+    int first_piece_size = 0;
+    size_t piece = find_second_compressed_piece(data, size, &first_piece_size);
+    expect(piece != 0, "saved game has a piece index with compressed pieces");
+    if (!piece) {
+        free(data);
+        return;
+    }
+    int piece_size = read_i32_at(data, piece);
+    uint8_t *modified = malloc(size);
+
+    expect(load_modified_save(data, size, 0) == FILE_LOAD_SUCCESS, "unmodified save loads");
+
+    // No larger than the data already read, so adding it to the used buffer size wraps around
+    int negative_sizes[NUM_NEGATIVE_SIZES] = { -1, -first_piece_size / 2, -first_piece_size };
+    for (int i = 0; i < NUM_NEGATIVE_SIZES; i++) {
+        memcpy(modified, data, size);
+        write_i32_at(modified, piece, negative_sizes[i]);
+        expect(load_modified_save(modified, size, 1) != FILE_LOAD_SUCCESS, "negative piece size is rejected");
+    }
+
+    memcpy(modified, data, size);
+    expect(load_modified_save(modified, piece + 4 + piece_size / 2, 0) != FILE_LOAD_SUCCESS,
+        "save truncated inside a piece is rejected");
+
+    free(modified);
+    free(data);
+}
+
+int main(void)
+{
+    if (!game_pre_init() || !game_init()) {
+        printf("Unable to initialize game\n");
+        return 1;
+    }
+    if (game_file_load_saved_game(INPUT_FILE) != FILE_LOAD_SUCCESS ||
+        !game_file_io_write_saved_game(OUTPUT_FILE)) {
+        printf("Unable to convert %s to %s\n", INPUT_FILE, OUTPUT_FILE);
+        return 1;
+    }
+    test_corrupt_piece_sizes();
+    remove(OUTPUT_FILE);
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("All corrupt save checks passed\n");
+    return 0;
+}
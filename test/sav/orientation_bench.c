@@ -0,0 +1,103 @@
+#include "bench/timer.h"
+#include "city/view.h"
+#include "core/time.h"
+#include "game/file.h"
+#include "game/file_editor.h"
+#include "game/game.h"
+#include "map/grid.h"
+#include "map/orientation.h"
+#include "map/terrain.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_ROTATIONS 40
+#define LARGEST_MAP_SIZE 5
+
+static int get_terrain(int x, int y)
+{
+    if (x % 8 == 0 || y % 8 == 0) {
+        return TERRAIN_ROAD;
+    }
+    if ((x / 16 + y / 16) % 5 == 0) {
+        return TERRAIN_WATER;
+    }
+    if (x % 8 == 4 && (y / 8) % 3 == 0) {
+        return TERRAIN_WALL;
+    }
+    if (y % 8 == 4 && (x / 8) % 3 == 1) {
+        return TERRAIN_AQUEDUCT;
+    }
+    if ((x * 7 + y * 13) % 11 == 0) {
+        return TERRAIN_TREE;
+    }
+    return 0;
+}
+
+static void create_largest_map(void)
+{
+    game_file_editor_create_scenario(LARGEST_MAP_SIZE);
+    int width, height;
+    map_grid_size(&width, &height);
+    // Shores, roads, walls and aqueducts all over the map, so every terrain context is used
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int terrain = get_terrain(x, y);
+            if (terrain) {
+                map_terrain_set(map_grid_offset(x, y), terrain);
+            }
+        }
+    }
+}
+
+static void benchmark_map(const char *name, int rotations)
+{
+    int width, height;
+    map_grid_size(&width, &height);
+    // The first rotation sets all images for the new terrain
+    city_view_rotate_left();
+    map_orientation_change(0);
+
+    time_micros start = bench_timer_micros();
+    for (int r = 0; r < rotations; r++) {
+        city_view_rotate_left();
+        map_orientation_change(0);
+    }
+    double millis = (bench_timer_micros() - start) / 1000.0;
+    printf("%s: %dx%d map, %d rotations in %.1f ms: %.3f ms per rotation\n",
+        name, width, height, rotations, millis, rotations > 0 ? millis / rotations : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+    int rotations = DEFAULT_ROTATIONS;
+    int first_file = 1;
+    if (argc > 2 && strcmp(argv[1], "-r") == 0) {
+        rotations = atoi(argv[2]);
+        first_file = 3;
+    }
+    if (rotations <= 0) {
+        printf("Usage: orientationbench [-r rotations] [file.sav ...]\n");
+        return -1;
+    }
+    if (!game_pre_init() || !game_init()) {
+        printf("Unable to initialize game\n");
+        return 1;
+    }
+    int result = 0;
+    if (first_file >= argc) {
+        create_largest_map();
+        benchmark_map("generated", rotations);
+    }
+    for (int i = first_file; i < argc; i++) {
+        if (game_file_load_saved_game(argv[i])) {
+            benchmark_map(argv[i], rotations);
+        } else {
+            printf("Unable to load saved game %s\n", argv[i]);
+            result = 1;
+        }
+    }
+    game_exit();
+    return result;
+}
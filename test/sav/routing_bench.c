@@ -0,0 +1,72 @@
+#include "figure/figure.h"
+#include "figure/route.h"
+#include "game/file.h"
+#include "game/game.h"
+#include "map/routing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DEFAULT_REPEATS 20
+
+static int benchmark_save(const char *saved_game, int repeats)
+{
+    if (!game_file_load_saved_game(saved_game)) {
+        printf("Unable to load saved game %s\n", saved_game);
+        return 0;
+    }
+    int routes = 0;
+    int start_hits, start_misses;
+    figure_route_get_cache_stats(&start_hits, &start_misses);
+    int start_nodes = map_routing_total_nodes_expanded();
+    clock_t start = clock();
+    for (int r = 0; r < repeats; r++) {
+        for (int i = 1; i < figure_count(); i++) {
+            figure *f = figure_get(i);
+            if (f->state != FIGURE_STATE_ALIVE || (!f->destination_x && !f->destination_y)) {
+                continue;
+            }
+            // Replay the route search the figure made, keeping its current path intact
+            figure copy = *f;
+            figure_route_add(&copy);
+            figure_route_remove(&copy);
+            routes++;
+        }
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    int nodes = map_routing_total_nodes_expanded() - start_nodes;
+    int hits, misses;
+    figure_route_get_cache_stats(&hits, &misses);
+    printf("%s: %d routes, %d nodes expanded in %.3f s: %.0f nodes/s, %.0f routes/s, cache %d hits %d misses\n",
+        saved_game, routes, nodes, seconds,
+        seconds > 0 ? nodes / seconds : 0.0, seconds > 0 ? routes / seconds : 0.0,
+        hits - start_hits, misses - start_misses);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("Usage: routingbench [-r repeats] file.sav [file2.sav ...]\n");
+        return -1;
+    }
+    int repeats = DEFAULT_REPEATS;
+    int first_file = 1;
+    if (argc > 3 && argv[1][0] == '-' && argv[1][1] == 'r') {
+        repeats = atoi(argv[2]);
+        first_file = 3;
+    }
+    if (!game_pre_init() || !game_init()) {
+        printf("Unable to initialize game\n");
+        return 1;
+    }
+    int result = 0;
+    for (int i = first_file; i < argc; i++) {
+        if (!benchmark_save(argv[i], repeats)) {
+            result = 1;
+        }
+    }
+    game_exit();
+    return result;
+}
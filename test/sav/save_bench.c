@@ -0,0 +1,69 @@
+#include "bench/timer.h"
+#include "core/file.h"
+#include "core/time.h"
+#include "game/file.h"
+#include "game/file_io.h"
+#include "game/game.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEFAULT_REPEATS 20
+#define OUTPUT_FILE "savebench.sav"
+
+static int benchmark_save(const char *saved_game, int repeats)
+{
+    if (!game_file_load_saved_game(saved_game)) {
+        printf("Unable to load saved game %s\n", saved_game);
+        return 0;
+    }
+    // Wall clock time, since the pieces are processed on several threads
+    time_micros start = bench_timer_micros();
+    for (int r = 0; r < repeats; r++) {
+        if (!game_file_io_read_saved_game(saved_game, 0)) {
+            printf("Unable to read saved game %s\n", saved_game);
+            return 0;
+        }
+    }
+    time_micros read_micros = bench_timer_micros() - start;
+
+    start = bench_timer_micros();
+    for (int r = 0; r < repeats; r++) {
+        if (!game_file_io_write_saved_game(OUTPUT_FILE)) {
+            printf("Unable to write saved game %s\n", OUTPUT_FILE);
+            return 0;
+        }
+    }
+    time_micros write_micros = bench_timer_micros() - start;
+    file_remove(OUTPUT_FILE);
+
+    printf("%s: read %.2f ms, write %.2f ms per save\n", saved_game,
+        read_micros / 1000.0 / repeats, write_micros / 1000.0 / repeats);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("Usage: savebench [-r repeats] file.sav [file2.sav ...]\n");
+        return -1;
+    }
+    int repeats = DEFAULT_REPEATS;
+    int first_file = 1;
+    if (argc > 3 && argv[1][0] == '-' && argv[1][1] == 'r') {
+        repeats = atoi(argv[2]);
+        first_file = 3;
+    }
+    if (repeats <= 0 || !game_pre_init() || !game_init()) {
+        printf("Unable to initialize game\n");
+        return 1;
+    }
+    int result = 0;
+    for (int i = first_file; i < argc; i++) {
+        if (!benchmark_save(argv[i], repeats)) {
+            result = 1;
+        }
+    }
+    game_exit();
+    return result;
+}
@@ -0,0 +1,136 @@
+#include "bench/timer.h"
+#include "core/time.h"
+#include "game/file.h"
+#include "game/game.h"
+#include "game/settings.h"
+#include "game/tick.h"
+#include "game/time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_TICKS 5000
+#define DEFAULT_OUTPUT_FILE "simbench.json"
+
+static int compare_micros(const void *a, const void *b)
+{
+    time_micros va = *(const time_micros *) a;
+    time_micros vb = *(const time_micros *) b;
+    return va < vb ? -1 : va > vb;
+}
+
+static time_micros percentile(const time_micros *sorted, int count, int percent)
+{
+    int index = (count * percent + 99) / 100 - 1;
+    if (index < 0) {
+        index = 0;
+    }
+    return sorted[index];
+}
+
+static void write_json_string(FILE *out, const char *str)
+{
+    fputc('"', out);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', out);
+        }
+        fputc(*str, out);
+    }
+    fputc('"', out);
+}
+
+static int benchmark_save(FILE *out, const char *saved_game, int ticks, int is_first)
+{
+    if (!game_file_load_saved_game(saved_game)) {
+        fprintf(stderr, "Unable to load saved game %s\n", saved_game);
+        return 0;
+    }
+    time_micros *tick_times = malloc(sizeof(time_micros) * ticks);
+    if (!tick_times) {
+        return 0;
+    }
+    setting_reset_speeds(500, setting_scroll_speed());
+    time_set_millis(0);
+    game_tick_profile_enable(1);
+    time_micros start = bench_timer_micros();
+    for (int i = 1; i <= ticks; i++) {
+        // At the highest speed, every 2 millis is exactly one tick
+        time_set_millis(2 * i);
+        time_micros tick_start = bench_timer_micros();
+        game_run();
+        tick_times[i - 1] = bench_timer_micros() - tick_start;
+    }
+    time_micros total = bench_timer_micros() - start;
+    game_tick_profile_enable(0);
+    qsort(tick_times, ticks, sizeof(time_micros), compare_micros);
+
+    double seconds = total / 1000000.0;
+    fprintf(out, "%s\n    {\n      \"save\": ", is_first ? "" : ",");
+    write_json_string(out, saved_game);
+    fprintf(out, ",\n      \"ticks\": %d,\n", ticks);
+    fprintf(out, "      \"seconds\": %.6f,\n", seconds);
+    fprintf(out, "      \"ticks_per_second\": %.1f,\n", seconds > 0 ? ticks / seconds : 0.0);
+    fprintf(out, "      \"tick_micros_p50\": %llu,\n", (unsigned long long) percentile(tick_times, ticks, 50));
+    fprintf(out, "      \"tick_micros_p99\": %llu,\n", (unsigned long long) percentile(tick_times, ticks, 99));
+    fprintf(out, "      \"tick_micros_max\": %llu,\n", (unsigned long long) tick_times[ticks - 1]);
+    fprintf(out, "      \"slots\": [");
+    const game_tick_slot_profile *slots = game_tick_profile_slots();
+    for (int i = 0; i < GAME_TIME_TICKS_PER_DAY; i++) {
+        fprintf(out, "%s\n        {\"tick\": %d, \"calls\": %u, \"total_micros\": %llu, \"average_micros\": %.1f}",
+            i ? "," : "", i, slots[i].calls, (unsigned long long) slots[i].total_micros,
+            slots[i].calls ? (double) slots[i].total_micros / slots[i].calls : 0.0);
+    }
+    fprintf(out, "\n      ]\n    }");
+    fprintf(stderr, "%s: %d ticks in %.3f s: %.0f ticks/s\n", saved_game, ticks, seconds,
+        seconds > 0 ? ticks / seconds : 0.0);
+    free(tick_times);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    int ticks = DEFAULT_TICKS;
+    const char *output_file = DEFAULT_OUTPUT_FILE;
+    int first_file = 1;
+    while (first_file + 1 < argc && argv[first_file][0] == '-') {
+        if (strcmp(argv[first_file], "-t") == 0) {
+            ticks = atoi(argv[first_file + 1]);
+        } else if (strcmp(argv[first_file], "-o") == 0) {
+            output_file = argv[first_file + 1];
+        } else {
+            break;
+        }
+        first_file += 2;
+    }
+    if (first_file >= argc || ticks <= 0) {
+        printf("Usage: simbench [-t ticks] [-o " DEFAULT_OUTPUT_FILE "] file.sav [file2.sav ...]\n");
+        return -1;
+    }
+    // The game logs to stdout, so the results always go to a file
+    FILE *out = fopen(output_file, "w");
+    if (!out) {
+        printf("Unable to open %s for writing\n", output_file);
+        return 1;
+    }
+    time_set_micros_source(bench_timer_micros);
+    if (!game_pre_init() || !game_init()) {
+        printf("Unable to initialize game\n");
+        return 1;
+    }
+    int result = 0;
+    int is_first = 1;
+    fprintf(out, "{\n  \"results\": [");
+    for (int i = first_file; i < argc; i++) {
+        if (benchmark_save(out, argv[i], ticks, is_first)) {
+            is_first = 0;
+        } else {
+            result = 1;
+        }
+    }
+    fprintf(out, "\n  ]\n}\n");
+    fclose(out);
+    game_exit();
+    return result;
+}
@@ -0,0 +1,52 @@
+#include "core/config.h"
+#include "graphics/screen.h"
+#include "input/mouse.h"
+#include "platform/cursor.h"
+#include "platform/platform.h"
+#include "platform/screen.h"
+
+#include "SDL.h"
+
+static mouse no_mouse;
+
+int config_get(config_key key)
+{
+    return 0;
+}
+
+int screen_width(void)
+{
+    return 1280;
+}
+
+int screen_height(void)
+{
+    return 800;
+}
+
+const mouse *mouse_get(void)
+{
+    return &no_mouse;
+}
+
+cursor_shape platform_cursor_get_current_shape(void)
+{
+    return CURSOR_DISABLED;
+}
+
+int platform_cursor_is_software(void)
+{
+    return 0;
+}
+
+int platform_screen_get_scale(void)
+{
+    return 100;
+}
+
+int platform_sdl_version_at_least(int major, int minor, int patch)
+{
+    SDL_version version;
+    SDL_GetVersion(&version);
+    return SDL_VERSIONNUM(version.major, version.minor, version.patch) >= SDL_VERSIONNUM(major, minor, patch);
+}
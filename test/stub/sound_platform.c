@@ -0,0 +1,63 @@
+#include "core/config.h"
+#include "core/dir.h"
+#include "core/file.h"
+#include "game/campaign.h"
+#include "platform/platform.h"
+
+#include "SDL.h"
+
+#include <string.h>
+
+int config_get(config_key key)
+{
+    return key == CONFIG_GENERAL_MASTER_VOLUME ? 100 : 1;
+}
+
+const char *config_get_string(config_string_key key)
+{
+    return "";
+}
+
+int game_campaign_has_file(const char *filename)
+{
+    return 0;
+}
+
+const char *game_campaign_get_name(void)
+{
+    return 0;
+}
+
+uint8_t *game_campaign_load_file(const char *filename, size_t *length)
+{
+    *length = 0;
+    return 0;
+}
+
+const char *dir_get_file(const char *filepath, int localizable)
+{
+    return filepath;
+}
+
+FILE *file_open(const char *filename, const char *mode)
+{
+    return fopen(filename, mode);
+}
+
+int file_close(FILE *stream)
+{
+    return fclose(stream) == 0;
+}
+
+int file_has_extension(const char *filename, const char *extension)
+{
+    const char *dot = strrchr(filename, '.');
+    return dot && SDL_strcasecmp(dot + 1, extension) == 0;
+}
+
+int platform_sdl_version_at_least(int major, int minor, int patch)
+{
+    SDL_version version;
+    SDL_GetVersion(&version);
+    return SDL_VERSIONNUM(version.major, version.minor, version.patch) >= SDL_VERSIONNUM(major, minor, patch);
+}
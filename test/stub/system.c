@@ -0,0 +1,21 @@
+#include "game/system.h"
+
+int system_get_cpu_count(void)
+{
+    return 1;
+}
+
+system_thread *system_thread_start(int (*function)(void *data), void *data)
+{
+    return 0;
+}
+
+int system_thread_is_finished(system_thread *thread)
+{
+    return 1;
+}
+
+int system_thread_wait(system_thread *thread)
+{
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "game/system.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+struct system_thread {
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    int (*function)(void *data);
+    void *data;
+    volatile long finished;
+    int result;
+};
+
+#ifdef _WIN32
+static DWORD WINAPI run_thread(LPVOID param)
+#else
+static void *run_thread(void *param)
+#endif
+{
+    system_thread *thread = param;
+    thread->result = thread->function(thread->data);
+#ifdef _WIN32
+    InterlockedExchange(&thread->finished, 1);
+    return 0;
+#else
+    __atomic_store_n(&thread->finished, 1, __ATOMIC_SEQ_CST);
+    return 0;
+#endif
+}
+
+int system_get_cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int) count : 1;
+#endif
+}
+
+system_thread *system_thread_start(int (*function)(void *data), void *data)
+{
+    system_thread *thread = malloc(sizeof(system_thread));
+    if (!thread) {
+        return 0;
+    }
+    thread->function = function;
+    thread->data = data;
+    thread->finished = 0;
+    thread->result = 0;
+#ifdef _WIN32
+    thread->handle = CreateThread(0, 0, run_thread, thread, 0, 0);
+    if (!thread->handle) {
+#else
+    if (pthread_create(&thread->handle, 0, run_thread, thread) != 0) {
+#endif
+        free(thread);
+        return 0;
+    }
+    return thread;
+}
+
+int system_thread_is_finished(system_thread *thread)
+{
+#ifdef _WIN32
+    return InterlockedCompareExchange(&thread->finished, 0, 0) != 0;
+#else
+    return __atomic_load_n(&thread->finished, __ATOMIC_SEQ_CST) != 0;
+#endif
+}
+
+int system_thread_wait(system_thread *thread)
+{
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, 0);
+#endif
+    int result = thread->result;
+    free(thread);
+    return result;
+}
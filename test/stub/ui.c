@@ -1,4 +1,5 @@
 #include "graphics/window.h"
+#include "widget/city_without_overlay.h"
 #include "widget/minimap.h"
 #include "window/building_info.h"
 #include "window/editor/map.h"
@@ -66,6 +67,9 @@ void window_popup_dialog_show(popup_dialog_type type, void (*okFunc)(int), int h
 void widget_minimap_invalidate(void)
 {}
 
+void city_without_overlay_invalidate_terrain_cache(void)
+{}
+
 int window_building_info_get_building_type(void)
 {
     return 0;